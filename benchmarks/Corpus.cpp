@@ -0,0 +1,228 @@
+/*
+ This file is part of vedgTools/QtXmlUtilities.
+ Copyright (C) 2014, 2015 Igor Kushnir <igorkuo AT Google mail>
+
+ vedgTools/QtXmlUtilities is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ vedgTools/QtXmlUtilities is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ vedgTools/QtXmlUtilities.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# include "Corpus.hpp"
+
+# include <QtGlobal>
+# include <QByteArray>
+# include <QString>
+# include <QLatin1String>
+# include <QBuffer>
+# include <QXmlStreamWriter>
+
+# include <algorithm>
+
+
+namespace QtUtilities
+{
+namespace Benchmarks
+{
+namespace
+{
+/// @brief Minimal linear congruential generator. std::uniform_int_distribution
+/// is not used because its output is implementation-defined.
+class Random
+{
+public:
+    explicit Random(const quint32 seed) : state_(seed) {}
+
+    quint32 next() {
+        state_ = state_ * 1664525u + 1013904223u;
+        return state_ >> 8;
+    }
+    int next(const int bound) { return int(next() % quint32(bound)); }
+
+    QString word(const int minLength, const int maxLength) {
+        const int length = minLength + next(maxLength - minLength + 1);
+        QString result(length, Qt::Uninitialized);
+        for (QChar & c : result)
+            c = QLatin1Char(char('a' + next(26)));
+        return result;
+    }
+
+private:
+    quint32 state_;
+};
+
+class Generator
+{
+public:
+    explicit Generator(const Shape shape)
+        : random_(quint32(shape) * 7919u + 1u), buffer_(& data_),
+          elementCount_(0) {
+        buffer_.open(QIODevice::WriteOnly);
+        writer_.setDevice(& buffer_);
+        writer_.setAutoFormatting(true);
+        writer_.writeStartDocument();
+    }
+
+    void start(const QString & tagName) {
+        writer_.writeStartElement(tagName);
+        ++elementCount_;
+    }
+    void end() { writer_.writeEndElement(); }
+    void textElement(const QString & tagName, const QString & text) {
+        writer_.writeTextElement(tagName, text);
+        ++elementCount_;
+    }
+    void attribute(const QString & name, const QString & value) {
+        writer_.writeAttribute(name, value);
+    }
+
+    Random & random() { return random_; }
+
+    Corpus finish(const Shape shape, const int size) {
+        writer_.writeEndDocument();
+        buffer_.close();
+        return Corpus { shape, size, data_, elementCount_ };
+    }
+
+private:
+    Random random_;
+    QByteArray data_;
+    QBuffer buffer_;
+    QXmlStreamWriter writer_;
+    int elementCount_;
+};
+
+QString number(const int n) { return QString::number(n); }
+
+void generateWide(Generator & g, const int size)
+{
+    g.start(QLatin1String("wide"));
+    for (int i = 0; i < size; ++i) {
+        g.textElement(QLatin1String("field_") + number(i),
+                      number(int(g.random().next())));
+    }
+    g.end();
+}
+
+void generateDeep(Generator & g, const int size)
+{
+    const int depth = std::max(1, std::min(size, maxDepth));
+    const int chainCount = std::max(1, size / depth);
+    g.start(QLatin1String("deep"));
+    for (int chain = 0; chain < chainCount; ++chain) {
+        for (int level = 0; level < depth; ++level) {
+            g.start(QLatin1String("level"));
+            g.textElement(QLatin1String("value"), number(level));
+        }
+        for (int level = 0; level < depth; ++level)
+            g.end();
+    }
+    g.end();
+}
+
+void generateLongList(Generator & g, const int size)
+{
+    g.start(QLatin1String("list"));
+    g.start(QLatin1String("items"));
+    for (int i = 0; i < size; ++i) {
+        g.start(QLatin1String("item"));
+        g.textElement(QLatin1String("id"), number(i));
+        g.textElement(QLatin1String("name"), g.random().word(4, 12));
+        g.end();
+    }
+    g.end();
+    g.end();
+}
+
+void generateAttributeHeavy(Generator & g, const int size)
+{
+    g.start(QLatin1String("attributes"));
+    for (int i = 0; i < size; ++i) {
+        g.start(QLatin1String("item"));
+        for (int a = 0; a < attributeCount; ++a) {
+            g.attribute(QLatin1String("a") + number(a),
+                        g.random().word(2, 10));
+        }
+        g.end();
+    }
+    g.end();
+}
+
+void generateTextHeavy(Generator & g, const int size)
+{
+    const int paragraphCount = std::max(1, size / 16);
+    g.start(QLatin1String("text"));
+    for (int i = 0; i < paragraphCount; ++i) {
+        QString text;
+        text.reserve(paragraphLength + 16);
+        while (text.size() < paragraphLength) {
+            text += g.random().word(1, 10);
+            text += QLatin1Char(' ');
+        }
+        text.truncate(paragraphLength);
+        g.start(QLatin1String("paragraph"));
+        g.textElement(QLatin1String("body"), text);
+        g.end();
+    }
+    g.end();
+}
+
+} // END unnamed namespace
+
+
+const char * name(const Shape shape)
+{
+    switch (shape) {
+        case Shape::Wide:
+            return "wide";
+        case Shape::Deep:
+            return "deep";
+        case Shape::LongList:
+            return "long-list";
+        case Shape::AttributeHeavy:
+            return "attribute-heavy";
+        case Shape::TextHeavy:
+            return "text-heavy";
+    }
+    return "unknown";
+}
+
+std::vector<Shape> allShapes()
+{
+    return { Shape::Wide, Shape::Deep, Shape::LongList, Shape::AttributeHeavy,
+             Shape::TextHeavy };
+}
+
+Corpus generate(const Shape shape, const int size)
+{
+    Generator generator(shape);
+    switch (shape) {
+        case Shape::Wide:
+            generateWide(generator, size);
+            break;
+        case Shape::Deep:
+            generateDeep(generator, size);
+            break;
+        case Shape::LongList:
+            generateLongList(generator, size);
+            break;
+        case Shape::AttributeHeavy:
+            generateAttributeHeavy(generator, size);
+            break;
+        case Shape::TextHeavy:
+            generateTextHeavy(generator, size);
+            break;
+    }
+    return generator.finish(shape, size);
+}
+
+} // END namespace Benchmarks
+} // END namespace QtUtilities
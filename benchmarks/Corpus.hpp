@@ -0,0 +1,81 @@
+/*
+ This file is part of vedgTools/QtXmlUtilities.
+ Copyright (C) 2014, 2015 Igor Kushnir <igorkuo AT Google mail>
+
+ vedgTools/QtXmlUtilities is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ vedgTools/QtXmlUtilities is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ vedgTools/QtXmlUtilities.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# ifndef QT_XML_UTILITIES_BENCHMARKS_CORPUS_HPP
+# define QT_XML_UTILITIES_BENCHMARKS_CORPUS_HPP
+
+# include <QByteArray>
+
+# include <vector>
+
+
+namespace QtUtilities
+{
+namespace Benchmarks
+{
+/// @brief Document shapes, each of which stresses a different part of the
+/// library.
+enum class Shape
+{
+    /// Root with size uniquely named children <field_i>: getUniqueChild().
+    Wide,
+    /// Chains of nested <level> elements, each of which has a <value> child:
+    /// parser recursion and repeated getUniqueChild() on short lists.
+    Deep,
+    /// <items> with size <item> children, each of which has <id> and <name>:
+    /// getChildren() and copyUniqueChildsTextTo<T>().
+    LongList,
+    /// <item> elements with attributeCount attributes each:
+    /// copyElementsAttributeTo().
+    AttributeHeavy,
+    /// <paragraph> elements with long text: copyUniqueChildsTextTo(QString).
+    TextHeavy
+};
+
+/// @return Lowercase name of shape for reports.
+const char * name(Shape shape);
+/// @return All shapes in declaration order.
+std::vector<Shape> allShapes();
+
+struct Corpus
+{
+    Shape shape;
+    int size;
+    QByteArray data;
+    /// Total number of elements in data, root included.
+    int elementCount;
+};
+
+/// Number of attributes of each <item> in AttributeHeavy corpora.
+constexpr int attributeCount = 16;
+/// Maximum nesting depth of Deep corpora.
+constexpr int maxDepth = 256;
+/// Length of each <paragraph>'s text in TextHeavy corpora.
+constexpr int paragraphLength = 4096;
+
+/// @brief Generates corpus of the specified shape, which contains about size
+/// payload elements (text-heavy corpora contain size / 16 paragraphs).
+/// The output depends only on shape and size: a fixed-seed linear
+/// congruential generator is used, so corpora are identical across runs,
+/// platforms and Qt versions.
+Corpus generate(Shape shape, int size);
+
+} // END namespace Benchmarks
+} // END namespace QtUtilities
+
+# endif // QT_XML_UTILITIES_BENCHMARKS_CORPUS_HPP
@@ -0,0 +1,416 @@
+/*
+ This file is part of vedgTools/QtXmlUtilities.
+ Copyright (C) 2014, 2015 Igor Kushnir <igorkuo AT Google mail>
+
+ vedgTools/QtXmlUtilities is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ vedgTools/QtXmlUtilities is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ vedgTools/QtXmlUtilities.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// @file Measures QtXmlUtilities reading and writing shortcuts on generated
+/// corpora and prints results as JSON.
+/// Usage: QtXmlUtilitiesBenchmarks [--sizes N[,N...]] [--repetitions N]
+///                                 [--output FILE]
+
+# include "Corpus.hpp"
+
+# include <QtXmlUtilities/ReadingShortcuts.hpp>
+# include <QtXmlUtilities/WritingShortcuts.hpp>
+
+# include <QtGlobal>
+# include <QByteArray>
+# include <QString>
+# include <QLatin1String>
+# include <QStringList>
+# include <QFile>
+# include <QTemporaryFile>
+# include <QDir>
+# include <QElapsedTimer>
+# include <QDomDocument>
+# include <QDomElement>
+
+# include <cstdio>
+# include <cstdlib>
+# include <cstring>
+# include <string>
+# include <vector>
+# include <algorithm>
+# include <functional>
+# include <exception>
+
+
+namespace QtUtilities
+{
+namespace Benchmarks
+{
+namespace
+{
+struct Options
+{
+    std::vector<int> sizes { 1000, 10000, 100000 };
+    int repetitions = 5;
+    QString output;
+};
+
+struct Result
+{
+    QString corpus;
+    int size;
+    QString operation;
+    qint64 bytes;
+    qint64 elements;
+    std::vector<qint64> nanoseconds;
+    /// How far the resident set size rose above its value at the start of
+    /// the operation (the warm-up run included), or -1 if unknown.
+    long peakMemoryDeltaKiB;
+};
+
+# ifdef Q_OS_LINUX
+/// @return Value of field (e.g. "VmRSS:") in /proc/self/status in KiB or -1.
+long procStatusKiB(const char * const field)
+{
+    QFile file(QLatin1String("/proc/self/status"));
+    if (! file.open(QIODevice::ReadOnly))
+        return -1;
+    const std::size_t length = std::strlen(field);
+    for (QByteArray line = file.readLine(); ! line.isEmpty();
+            line = file.readLine()) {
+        if (line.startsWith(field)) {
+            bool ok;
+            const long kiB = line.mid(int(length)).trimmed().split(' ').at(
+                                 0).toLong(& ok);
+            return ok ? kiB : -1;
+        }
+    }
+    return -1;
+}
+# endif
+
+/// @brief Resets the peak resident set size of this process to the current
+/// one, so that peakMemoryDeltaKiB() measures only what follows.
+/// ru_maxrss can not be used for this: it is the peak of the whole process
+/// so far and usually reflects an earlier, larger corpus.
+/// @return Current resident set size in KiB or -1 if peak memory can not be
+/// measured per operation on this platform (only Linux is supported).
+long resetPeakMemory()
+{
+# ifdef Q_OS_LINUX
+    QFile clearRefs(QLatin1String("/proc/self/clear_refs"));
+    if (! clearRefs.open(QIODevice::WriteOnly) || clearRefs.write("5") != 1)
+        return -1;
+    clearRefs.close();
+    return procStatusKiB("VmRSS:");
+# else
+    return -1;
+# endif
+}
+
+/// @param startKiB Value returned by resetPeakMemory().
+/// @return Growth of the peak resident set size since startKiB in KiB or -1.
+long peakMemoryDeltaKiB(const long startKiB)
+{
+# ifdef Q_OS_LINUX
+    if (startKiB < 0)
+        return -1;
+    const long peakKiB = procStatusKiB("VmHWM:");
+    return peakKiB < 0 ? -1 : std::max(peakKiB - startKiB, 0L);
+# else
+    Q_UNUSED(startKiB);
+    return -1;
+# endif
+}
+
+/// Prevents the compiler from discarding results of measured operations.
+volatile qint64 sink = 0;
+
+class Runner
+{
+public:
+    explicit Runner(const Options & options) : options_(options) {}
+
+    /// @brief Runs operation options_.repetitions times (after one warm-up
+    /// run) and records a result.
+    /// @param bytes Number of bytes processed by a single run.
+    /// @param elements Number of elements processed by a single run.
+    void run(const Corpus & corpus, const char * const operation,
+             const qint64 bytes, const qint64 elements,
+             const std::function<void ()> & function) {
+        const long startMemoryKiB = resetPeakMemory();
+        function();
+        Result result { QLatin1String(name(corpus.shape)), corpus.size,
+                        QLatin1String(operation), bytes, elements, {}, -1 };
+        QElapsedTimer timer;
+        for (int i = 0; i < options_.repetitions; ++i) {
+            timer.start();
+            function();
+            result.nanoseconds.push_back(timer.nsecsElapsed());
+        }
+        result.peakMemoryDeltaKiB = peakMemoryDeltaKiB(startMemoryKiB);
+        results_.push_back(std::move(result));
+    }
+
+    const std::vector<Result> & results() const { return results_; }
+
+private:
+    const Options & options_;
+    std::vector<Result> results_;
+};
+
+void benchmarkTraversal(Runner & runner, const Corpus & corpus,
+                        const QDomElement & root)
+{
+    using namespace XmlReading;
+    switch (corpus.shape) {
+        case Shape::Wide: {
+            QStringList tagNames;
+            for (int i = 0; i < corpus.size; i += std::max(1, corpus.size / 64))
+                tagNames << QLatin1String("field_") + QString::number(i);
+            runner.run(corpus, "getUniqueChild", 0, tagNames.size(), [&] {
+                for (const QString & tagName : tagNames) {
+                    int value = 0;
+                    copyUniqueChildsTextTo(root, tagName, value);
+                    sink += value;
+                }
+            });
+            break;
+        }
+        case Shape::Deep:
+            runner.run(corpus, "getUniqueChild", 0, corpus.elementCount, [&] {
+                for (QDomElement chain = root.firstChildElement();
+                        ! chain.isNull(); chain = chain.nextSiblingElement()) {
+                    for (QDomElement level = chain; ! level.isNull();
+                            level = getUniqueChild(level,
+                                                   QLatin1String("level"))) {
+                        int value = 0;
+                        copyUniqueChildsTextTo(level, QLatin1String("value"),
+                                               value);
+                        sink += value;
+                    }
+                }
+            });
+            break;
+        case Shape::LongList: {
+            const QDomElement items =
+                getUniqueChild(root, QLatin1String("items"));
+            runner.run(corpus, "getChildren", 0, corpus.size, [&] {
+                sink += qint64(
+                            getChildren(items, QLatin1String("item")).size());
+            });
+            runner.run(corpus, "copyUniqueChildsTextTo<int>", 0, corpus.size,
+            [&] {
+                const std::vector<int> ids = getChildren<std::vector<int>>(
+                    items, QString::fromLatin1("item"),
+                [](const QDomElement & item) {
+                    int id = 0;
+                    copyUniqueChildsTextTo(item, QLatin1String("id"), id);
+                    return id;
+                });
+                sink += qint64(ids.size());
+            });
+            break;
+        }
+        case Shape::AttributeHeavy: {
+            QStringList names;
+            for (int a = 0; a < attributeCount; ++a)
+                names << QLatin1String("a") + QString::number(a);
+            runner.run(corpus, "copyElementsAttributeTo", 0,
+                       qint64(corpus.size) * attributeCount, [&] {
+                QString value;
+                for (QDomElement item = root.firstChildElement();
+                        ! item.isNull(); item = item.nextSiblingElement()) {
+                    for (const QString & attributeName : names) {
+                        copyElementsAttributeTo(item, attributeName, value);
+                        sink += value.size();
+                    }
+                }
+            });
+            break;
+        }
+        case Shape::TextHeavy:
+            runner.run(corpus, "copyUniqueChildsTextTo<QString>", 0,
+                       corpus.elementCount, [&] {
+                QString text;
+                for (QDomElement paragraph = root.firstChildElement();
+                        ! paragraph.isNull();
+                        paragraph = paragraph.nextSiblingElement()) {
+                    copyUniqueChildsTextTo(paragraph, QLatin1String("body"),
+                                           text);
+                    sink += text.size();
+                }
+            });
+            break;
+    }
+}
+
+void benchmarkCorpus(Runner & runner, const Corpus & corpus)
+{
+    using namespace XmlReading;
+    const qint64 bytes = corpus.data.size();
+    runner.run(corpus, "loadRootFromData", bytes, corpus.elementCount, [&] {
+        sink += loadRootFromData(corpus.data).isNull();
+    });
+
+    // A unique name lets concurrent benchmark runs share the temp directory.
+    QTemporaryFile file(QDir::temp().filePath(
+                            QLatin1String("QtXmlUtilitiesBenchmark-XXXXXX")));
+    if (! file.open() || file.write(corpus.data) != bytes) {
+        throw XmlWriting::WriteError(
+            QString::fromLatin1("could not write temporary file %1.").arg(
+                file.fileName()));
+    }
+    // Closed so that save() can replace the file; it is still removed by the
+    // destructor.
+    file.close();
+    const QString filename = file.fileName();
+    runner.run(corpus, "loadRoot", bytes, corpus.elementCount, [&] {
+        sink += loadRoot(filename).isNull();
+    });
+    runner.run(corpus, "loadRootMapped", bytes, corpus.elementCount, [&] {
+        sink += loadRootMapped(filename).isNull();
+    });
+
+    const QDomElement root = loadRootFromData(corpus.data);
+    runner.run(corpus, "save", bytes, corpus.elementCount, [&] {
+        XmlWriting::save(root.ownerDocument(), filename);
+    });
+
+    benchmarkTraversal(runner, corpus, root);
+}
+
+void benchmarkWriting(Runner & runner, const int size)
+{
+    using namespace XmlWriting;
+    QStringList strings;
+    for (int i = 0; i < size; ++i)
+        strings << QLatin1String("string") + QString::number(i);
+    const Corpus corpus { Shape::LongList, size, QByteArray(), size + 1 };
+    runner.run(corpus, "createStringListElement", 0, size + 1, [&] {
+        QDomDocument doc = createDocument();
+        sink += createStringListElement(doc, QLatin1String("list"),
+                                        QLatin1String("string"),
+                                        strings).isNull();
+    });
+}
+
+QString jsonString(const QString & s)
+{
+    QString result = QLatin1String("\"");
+    for (const QChar c : s) {
+        if (c == QLatin1Char('"') || c == QLatin1Char('\\'))
+            result += QLatin1Char('\\');
+        result += c;
+    }
+    return result + QLatin1Char('"');
+}
+
+QString toJson(const std::vector<Result> & results, const Options & options)
+{
+    QStringList entries;
+    for (const Result & r : results) {
+        std::vector<qint64> sorted = r.nanoseconds;
+        std::sort(sorted.begin(), sorted.end());
+        const qint64 minNs = sorted.front();
+        const qint64 medianNs = sorted[sorted.size() / 2];
+        const double seconds = std::max<qint64>(medianNs, 1) * 1e-9;
+        entries << QString::fromLatin1(
+                    "    {\"corpus\": %1, \"size\": %2, \"operation\": %3, "
+                    "\"bytes\": %4, \"elements\": %5, \"minNs\": %6, "
+                    "\"medianNs\": %7, \"maxNs\": %8, \"mbPerS\": %9, "
+                    "\"elementsPerS\": %10, \"peakMemoryDeltaKiB\": %11}").arg(
+                    jsonString(r.corpus)).arg(r.size).arg(
+                    jsonString(r.operation)).arg(r.bytes).arg(r.elements).arg(
+                    minNs).arg(medianNs).arg(sorted.back()).arg(
+                    r.bytes / 1e6 / seconds, 0, 'f', 3).arg(
+                    r.elements / seconds, 0, 'f', 1).arg(
+                    r.peakMemoryDeltaKiB);
+    }
+    return QString::fromLatin1(
+               "{\n  \"qtVersion\": %1,\n  \"repetitions\": %2,\n"
+               "  \"results\": [\n%3\n  ]\n}\n").arg(
+               jsonString(QLatin1String(qVersion()))).arg(
+               options.repetitions).arg(entries.join(QLatin1String(",\n")));
+}
+
+[[noreturn]] void usage(const char * const program)
+{
+    std::fprintf(stderr, "Usage: %s [--sizes N[,N...]] [--repetitions N] "
+                 "[--output FILE]\n", program);
+    std::exit(2);
+}
+
+Options parseOptions(const int argc, char * const argv[])
+{
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        if (i + 1 == argc)
+            usage(argv[0]);
+        const char * const value = argv[++i];
+        if (std::strcmp(argv[i - 1], "--sizes") == 0) {
+            options.sizes.clear();
+            for (const QString & size :
+                    QString::fromLocal8Bit(value).split(QLatin1Char(','))) {
+                bool ok;
+                options.sizes.push_back(size.toInt(& ok));
+                if (! ok || options.sizes.back() <= 0)
+                    usage(argv[0]);
+            }
+        }
+        else if (std::strcmp(argv[i - 1], "--repetitions") == 0) {
+            options.repetitions = std::atoi(value);
+            if (options.repetitions <= 0)
+                usage(argv[0]);
+        }
+        else if (std::strcmp(argv[i - 1], "--output") == 0)
+            options.output = QString::fromLocal8Bit(value);
+        else
+            usage(argv[0]);
+    }
+    return options;
+}
+
+} // END unnamed namespace
+} // END namespace Benchmarks
+} // END namespace QtUtilities
+
+
+int main(int argc, char * argv[])
+{
+    using namespace QtUtilities::Benchmarks;
+    const Options options = parseOptions(argc, argv);
+    Runner runner(options);
+    try {
+        for (const int size : options.sizes) {
+            for (const Shape shape : allShapes()) {
+                std::fprintf(stderr, "%s/%d\n", name(shape), size);
+                benchmarkCorpus(runner, generate(shape, size));
+            }
+            benchmarkWriting(runner, size);
+        }
+    }
+    catch (const std::exception & e) {
+        std::fprintf(stderr, "Benchmark failed: %s\n", e.what());
+        return 1;
+    }
+
+    const QByteArray json = toJson(runner.results(), options).toUtf8();
+    if (options.output.isEmpty()) {
+        std::fwrite(json.constData(), 1, std::size_t(json.size()), stdout);
+        return 0;
+    }
+    QFile file(options.output);
+    if (! file.open(QIODevice::WriteOnly) || file.write(json) != json.size()) {
+        std::fprintf(stderr, "Could not write %s\n",
+                     qPrintable(options.output));
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,73 @@
+/*
+ This file is part of vedgTools/QtXmlUtilities.
+ Copyright (C) 2014, 2015 Igor Kushnir <igorkuo AT Google mail>
+
+ vedgTools/QtXmlUtilities is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ vedgTools/QtXmlUtilities is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ vedgTools/QtXmlUtilities.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# ifndef QT_XML_UTILITIES_ASYNC_WRITING_HPP
+# define QT_XML_UTILITIES_ASYNC_WRITING_HPP
+
+# include <QtXmlUtilities/WritingShortcuts.hpp>
+
+# include <QtGlobal>
+# include <QString>
+# include <QDomDocument>
+
+# include <future>
+# include <vector>
+
+
+QT_FORWARD_DECLARE_CLASS(QThreadPool)
+
+namespace QtUtilities
+{
+namespace XmlWriting
+{
+/// NOTE: QDomNode handles are not thread-safe. Functions below that take a
+/// QDomDocument by rvalue reference take ownership of it: the passed handle
+/// is cleared, and the caller must not use any other handle to the document
+/// or to its nodes afterwards.
+/// Functions below run on pool or, if pool is nullptr, on
+/// QThreadPool::globalInstance(). The returned future rethrows WriteError
+/// from get() in case of saving error.
+
+/// @brief Takes ownership of doc, then serializes it and writes it to file,
+/// specified by filename, on a thread of pool.
+std::future<void> saveAsync(QDomDocument && doc, const QString & filename,
+                            int indent = 4, QThreadPool * pool = nullptr);
+/// @brief Serializes document on the calling thread, then writes it to file,
+/// specified by filename, on a thread of pool. document can be used and
+/// modified right after this function returns.
+std::future<void> saveAsync(const Document & document,
+                            const QString & filename, int indent = 4,
+                            QThreadPool * pool = nullptr);
+
+struct DocumentToSave {
+    QDomDocument document;
+    QString filename;
+    int indent;
+};
+
+/// @brief Takes ownership of all documents, serializes them in parallel and
+/// writes them one after another, so that writes to the same disk do not
+/// compete. Each document is written even if saving of another one fails.
+/// The returned future rethrows the first error that occurred.
+std::future<void> saveAsync(std::vector<DocumentToSave> && documents,
+                            QThreadPool * pool = nullptr);
+
+} // END namespace XmlWriting
+} // END namespace QtUtilities
+
+# endif // QT_XML_UTILITIES_ASYNC_WRITING_HPP
@@ -0,0 +1,102 @@
+/*
+ This file is part of vedgTools/QtXmlUtilities.
+ Copyright (C) 2014, 2015 Igor Kushnir <igorkuo AT Google mail>
+
+ vedgTools/QtXmlUtilities is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ vedgTools/QtXmlUtilities is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ vedgTools/QtXmlUtilities.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# ifndef QT_XML_UTILITIES_BINARY_HPP
+# define QT_XML_UTILITIES_BINARY_HPP
+
+# include <QtGlobal>
+# include <QByteArray>
+# include <QString>
+
+
+namespace QtUtilities
+{
+/// @brief Text encodings of binary data stored in XML elements.
+enum class BinaryEncoding
+{
+    /// RFC 4648 base64 with padding; 4 characters per 3 bytes.
+    Base64,
+    /// Lowercase hexadecimal; 2 characters per byte. Uppercase digits are
+    /// accepted when decoding.
+    Hex
+};
+
+/// @return Name of encoding for error messages, e.g. "base64".
+const char * encodingName(BinaryEncoding encoding);
+
+/// @return Number of characters in the encoding of size bytes.
+int encodedLength(int size, BinaryEncoding encoding);
+
+/// @brief Encodes size bytes of data into
+/// encodedLength(size, encoding) characters starting at destination.
+void encodeBinary(const char * data, int size, BinaryEncoding encoding,
+                  QChar * destination);
+/// @return data encoded into a QString of the exact size in a single pass.
+QString encodeBinary(const QByteArray & data, BinaryEncoding encoding);
+
+/// @brief Incremental decoder, which decodes text that arrives in pieces
+/// (e.g. in several QXmlStreamReader tokens) straight into a single
+/// QByteArray. Whitespace in the text is ignored.
+class BinaryDecoder
+{
+public:
+    explicit BinaryDecoder(BinaryEncoding encoding)
+        : encoding_(encoding), size_(0), bits_(0), pending_(0),
+          padding_(0) {}
+
+    /// @brief Decodes the next length characters of the text. Space for the
+    /// decoded bytes is allocated once per call.
+    /// @return false if text contains invalid characters. The decoder must
+    /// not be used after that.
+    bool add(const QChar * text, int length);
+    bool add(const QString & text) {
+        return add(text.constData(), text.size());
+    }
+
+    /// @brief Must be called after the whole text has been added.
+    /// @return false if the text was truncated.
+    bool finish();
+
+    /// @return Decoded data. Must be called after finish().
+    QByteArray takeResult();
+
+private:
+    /// @brief Grows result_ so that it can hold maxBytes more bytes.
+    void reserve(int maxBytes);
+
+    BinaryEncoding encoding_;
+    QByteArray result_;
+    /// Number of decoded bytes in result_.
+    int size_;
+    /// Bits of the characters that do not form a whole byte group yet.
+    quint32 bits_;
+    /// Number of characters in bits_.
+    int pending_;
+    /// Number of '=' characters seen.
+    int padding_;
+};
+
+/// @brief Decodes text into destination. destination is not changed if text
+/// is invalid.
+/// @return true on success.
+bool decodeBinary(const QString & text, BinaryEncoding encoding,
+                  QByteArray & destination);
+
+} // END namespace QtUtilities
+
+# endif // QT_XML_UTILITIES_BINARY_HPP
@@ -0,0 +1,223 @@
+/*
+ This file is part of vedgTools/QtXmlUtilities.
+ Copyright (C) 2014, 2015 Igor Kushnir <igorkuo AT Google mail>
+
+ vedgTools/QtXmlUtilities is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ vedgTools/QtXmlUtilities is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ vedgTools/QtXmlUtilities.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# ifndef QT_XML_UTILITIES_CHILD_RANGE_HPP
+# define QT_XML_UTILITIES_CHILD_RANGE_HPP
+
+# include <QtXmlUtilities/ReadingShortcuts.hpp>
+
+# include <QString>
+# include <QLatin1String>
+# include <QDomElement>
+
+# include <cstddef>
+# include <utility>
+# include <iterator>
+# include <type_traits>
+
+
+namespace QtUtilities
+{
+namespace XmlReading
+{
+/// @brief Forward iterator over sibling elements with the same name.
+/// Advancing the iterator looks up the next matching sibling, so no
+/// collection of children is built. The iterator keeps its own copy of the
+/// tag name, so it may outlive the range that has created it.
+/// @tparam TString QString or QLatin1String.
+template <class TString>
+class ChildIterator
+{
+public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef QDomElement value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const QDomElement * pointer;
+    typedef const QDomElement & reference;
+
+    /// @brief Constructs the end iterator.
+    ChildIterator() : tagName_(QLatin1String("")) {}
+    ChildIterator(QDomElement current, TString tagName)
+        : current_(std::move(current)), tagName_(std::move(tagName)) {}
+
+    reference operator*() const { return current_; }
+    pointer operator->() const { return & current_; }
+
+    ChildIterator & operator++() {
+        current_ = detail::nextSiblingElement(current_, tagName_);
+        return *this;
+    }
+    ChildIterator operator++(int) {
+        ChildIterator old = *this;
+        ++*this;
+        return old;
+    }
+
+    /// NOTE: all null (past-the-end) iterators are equal.
+    friend bool operator==(const ChildIterator & lhs,
+                           const ChildIterator & rhs) {
+        return lhs.current_ == rhs.current_;
+    }
+    friend bool operator!=(const ChildIterator & lhs,
+                           const ChildIterator & rhs) {
+        return !(lhs == rhs);
+    }
+
+private:
+    QDomElement current_;
+    /// QString is implicitly shared and QLatin1String is a pointer and a
+    /// size, so copying the iterator is cheap.
+    TString tagName_;
+};
+
+/// @brief Lazy range of the children with name=tagName of an element in the
+/// order of appearance. Can be used in range-based for loops, with standard
+/// algorithms and with transformed(). Stopping early costs nothing for the
+/// remaining children.
+/// NOTE: the range reflects the current state of the DOM; it must not be
+/// used while matching children are being removed.
+template <class TString>
+class ChildRange
+{
+public:
+    typedef ChildIterator<TString> iterator;
+    typedef iterator const_iterator;
+
+    /// @param first First child with name=tagName or null element.
+    ChildRange(QDomElement first, TString tagName)
+        : first_(std::move(first)), tagName_(std::move(tagName)) {}
+
+    iterator begin() const { return iterator(first_, tagName_); }
+    iterator end() const { return iterator(); }
+
+    bool empty() const { return first_.isNull(); }
+    /// @return Number of elements in the range. Walks over all of them, but
+    /// does not store them; useful for reserving space in a container.
+    std::size_t count() const {
+        return std::size_t(std::distance(begin(), end()));
+    }
+
+private:
+    QDomElement first_;
+    TString tagName_;
+};
+
+/// @return Lazy range of e's children with name=tagName.
+inline ChildRange<QString> children(const QDomElement & e,
+                                    const QString & tagName)
+{
+    return ChildRange<QString>(e.firstChildElement(tagName), tagName);
+}
+inline ChildRange<QLatin1String> children(const QDomElement & e,
+        QLatin1String tagName)
+{
+    return ChildRange<QLatin1String>(detail::firstChildElement(e, tagName),
+                                     tagName);
+}
+
+
+/// @brief Iterator adapter, which applies a function to the dereferenced
+/// value of the underlying iterator on each dereference. As dereferencing
+/// returns a new value rather than a reference, this is an input iterator.
+/// NOTE: the iterator refers to the function of its TransformRange, so it
+/// must not outlive the range.
+template <class Iterator, typename Function>
+class TransformIterator
+{
+public:
+    typedef std::input_iterator_tag iterator_category;
+    typedef typename std::decay<
+    decltype(std::declval<const Function &>()(
+                 *std::declval<Iterator>()))>::type value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const value_type * pointer;
+    typedef value_type reference;
+
+    TransformIterator(Iterator it, const Function & function)
+        : it_(std::move(it)), function_(& function) {}
+
+    value_type operator*() const { return (*function_)(*it_); }
+
+    TransformIterator & operator++() {
+        ++it_;
+        return *this;
+    }
+    TransformIterator operator++(int) {
+        TransformIterator old = *this;
+        ++*this;
+        return old;
+    }
+
+    friend bool operator==(const TransformIterator & lhs,
+                           const TransformIterator & rhs) {
+        return lhs.it_ == rhs.it_;
+    }
+    friend bool operator!=(const TransformIterator & lhs,
+                           const TransformIterator & rhs) {
+        return !(lhs == rhs);
+    }
+
+private:
+    Iterator it_;
+    const Function * function_;
+};
+
+/// @brief Lazy range, which applies function to each element of range when
+/// it is dereferenced.
+template <class Range, typename Function>
+class TransformRange
+{
+public:
+    typedef TransformIterator<typename Range::const_iterator, Function>
+    iterator;
+    typedef iterator const_iterator;
+
+    TransformRange(Range range, Function function)
+        : range_(std::move(range)), function_(std::move(function)) {}
+
+    iterator begin() const { return iterator(range_.begin(), function_); }
+    iterator end() const { return iterator(range_.end(), function_); }
+
+    bool empty() const { return range_.empty(); }
+    std::size_t count() const { return range_.count(); }
+
+private:
+    Range range_;
+    Function function_;
+};
+
+/// @return Lazy range of function(element) for each element of range.
+/// For example:
+/// @code
+/// for (const QString & name : transformed(children(e, "item"),
+///                                         [](const QDomElement & item) {
+///                                             return item.text();
+///                                         }))
+///     process(name);
+/// @endcode
+template <class Range, typename Function>
+TransformRange<Range, Function> transformed(Range range, Function function)
+{
+    return TransformRange<Range, Function>(std::move(range),
+                                           std::move(function));
+}
+
+} // END namespace XmlReading
+} // END namespace QtUtilities
+
+# endif // QT_XML_UTILITIES_CHILD_RANGE_HPP
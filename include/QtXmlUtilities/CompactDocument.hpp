@@ -0,0 +1,268 @@
+/*
+ This file is part of vedgTools/QtXmlUtilities.
+ Copyright (C) 2014, 2015 Igor Kushnir <igorkuo AT Google mail>
+
+ vedgTools/QtXmlUtilities is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ vedgTools/QtXmlUtilities is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ vedgTools/QtXmlUtilities.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# ifndef QT_XML_UTILITIES_COMPACT_DOCUMENT_HPP
+# define QT_XML_UTILITIES_COMPACT_DOCUMENT_HPP
+
+# include <QtXmlUtilities/ReadingShortcuts.hpp>
+# include <QtXmlUtilities/ReadResult.hpp>
+
+# include <QtGlobal>
+# include <QString>
+# include <QLatin1String>
+# include <QHash>
+
+# include <memory>
+# include <vector>
+# include <type_traits>
+
+
+QT_FORWARD_DECLARE_CLASS(QByteArray)
+QT_FORWARD_DECLARE_CLASS(QIODevice)
+QT_FORWARD_DECLARE_CLASS(QStringList)
+QT_FORWARD_DECLARE_CLASS(QDomElement)
+
+namespace QtUtilities
+{
+namespace XmlReading
+{
+namespace detail
+{
+struct CompactNode {
+    /// Index in CompactData::names.
+    qint32 name;
+    /// Indices in CompactData::nodes or -1.
+    qint32 firstChild, nextSibling;
+    /// Attributes are CompactData::attributes[firstAttribute,
+    /// firstAttribute + attributeCount).
+    qint32 firstAttribute, attributeCount;
+    /// Text of the element (including text of its descendants) is
+    /// CompactData::texts[textBegin, textEnd).
+    qint32 textBegin, textEnd;
+};
+
+struct CompactAttribute {
+    qint32 name;
+    /// Value is CompactData::values[valueBegin, valueEnd).
+    qint32 valueBegin, valueEnd;
+};
+
+/// @brief Storage of CompactDocument. Is never modified after construction.
+struct CompactData {
+    /// @return Index of name in names or -1.
+    qint32 nameIndex(const QString & name) const {
+        return nameIndices.value(name, -1);
+    }
+
+    /// Elements in document order; the root element is nodes[0].
+    std::vector<CompactNode> nodes;
+    std::vector<CompactAttribute> attributes;
+    /// Interned element and attribute names.
+    std::vector<QString> names;
+    QHash<QString, qint32> nameIndices;
+    /// Character data of all elements in document order. Text of each element
+    /// and its descendants is contiguous in this pool.
+    QString texts;
+    /// Attribute values.
+    QString values;
+};
+
+} // END namespace detail
+
+
+/// @brief Lightweight handle of an element of CompactDocument. Mirrors the
+/// read-only subset of QDomElement, which is used by XmlReading shortcuts.
+/// Is valid as long as any CompactDocument, which shares the data, exists.
+class CompactElement
+{
+public:
+    /// @brief Constructs null element.
+    CompactElement() : data_(nullptr), index_(-1) {}
+
+    bool isNull() const { return data_ == nullptr; }
+
+    /// NOTE: like QDomElement, a null element has empty name, text and no
+    /// attributes or children.
+    QString tagName() const {
+        return isNull() ? QString() : data_->names[std::size_t(node().name)];
+    }
+    /// @return Concatenated text of the element and its descendants, same as
+    /// QDomElement::text().
+    QString text() const {
+        if (isNull())
+            return QString();
+        const detail::CompactNode & n = node();
+        return data_->texts.mid(n.textBegin, n.textEnd - n.textBegin);
+    }
+
+    bool hasAttribute(const QString & name) const {
+        return findAttribute(name) != nullptr;
+    }
+    QString attribute(const QString & name,
+                      const QString & defaultValue = QString()) const;
+
+    /// @return First child element with name=tagName (any name if tagName is
+    /// empty) or null element.
+    CompactElement firstChildElement(const QString & tagName = QString()) const;
+    CompactElement firstChildElement(QLatin1String tagName) const;
+    /// @return Next sibling element with name=tagName (any name if tagName is
+    /// empty) or null element.
+    CompactElement nextSiblingElement(
+        const QString & tagName = QString()) const;
+    CompactElement nextSiblingElement(QLatin1String tagName) const;
+
+    friend bool operator==(const CompactElement & lhs,
+                           const CompactElement & rhs) {
+        return lhs.data_ == rhs.data_ && lhs.index_ == rhs.index_;
+    }
+    friend bool operator!=(const CompactElement & lhs,
+                           const CompactElement & rhs) {
+        return !(lhs == rhs);
+    }
+
+private:
+    friend class CompactDocument;
+
+    CompactElement(const detail::CompactData * data, qint32 index)
+        : data_(index < 0 ? nullptr : data), index_(index) {}
+
+    const detail::CompactNode & node() const {
+        return data_->nodes[std::size_t(index_)];
+    }
+    const detail::CompactAttribute * findAttribute(const QString & name) const;
+    /// @return Element at index or the first following sibling of it with
+    /// name=nameIndex.
+    CompactElement findFrom(qint32 index, qint32 nameIndex) const;
+    CompactElement findFrom(qint32 index, QLatin1String tagName) const;
+
+    const detail::CompactData * data_;
+    qint32 index_;
+};
+
+template <>
+struct IsElement<CompactElement> : std::true_type {};
+
+
+/// @brief Immutable read-only document stored in a few flat arrays: elements
+/// and attributes refer to each other by indices, names are interned and
+/// all texts are kept in a single pool. It takes a fraction of the memory of
+/// an equivalent QDomDocument and is much faster to traverse.
+/// Comments, processing instructions and whitespace-only texts are not
+/// stored.
+/// Copies share the data. The data is frozen when the document is loaded
+/// and is never modified afterwards, so a document (or a copy of it) and its
+/// elements may be used from any number of threads concurrently without
+/// copies or locks. This applies to all const member functions of
+/// CompactDocument and CompactElement and to all XmlReading shortcuts that
+/// take CompactElement. Unlike QDomNode handles, CompactElement handles have
+/// no reference counting and may be freely copied between threads.
+/// A document must not be destroyed or assigned to while another thread is
+/// using the same CompactDocument object; copies of it are independent.
+class CompactDocument
+{
+public:
+    /// @brief Constructs empty document, whose root element is null.
+    CompactDocument() = default;
+
+    CompactElement root() const {
+        return data_ == nullptr ? CompactElement() :
+               CompactElement(data_.get(), 0);
+    }
+
+    /// @return Number of elements in the document.
+    std::size_t elementCount() const {
+        return data_ == nullptr ? 0 : data_->nodes.size();
+    }
+
+private:
+    friend CompactDocument loadCompactDocument(const QString & filename);
+    friend CompactDocument loadCompactDocument(QIODevice & device);
+    friend CompactDocument loadCompactDocumentFromData(const QByteArray & data);
+    friend CompactDocument freeze(const QDomElement & root);
+    friend CompactDocument loadCompactDocumentCached(
+        const QString & filename, const QString & cacheDirectory);
+
+    explicit CompactDocument(std::shared_ptr<const detail::CompactData> data)
+        : data_(std::move(data)) {}
+
+    std::shared_ptr<const detail::CompactData> data_;
+};
+
+/// @brief Loads document from file specified by filename.
+/// @throw ReadError If the file could not be opened or parsed.
+CompactDocument loadCompactDocument(const QString & filename);
+/// @brief Loads document from device. device is opened for reading if it is
+/// not open yet.
+/// @throw ReadError If device could not be opened or parsed.
+CompactDocument loadCompactDocument(QIODevice & device);
+/// @brief Loads document from data.
+/// @throw ReadError If data could not be parsed.
+CompactDocument loadCompactDocumentFromData(const QByteArray & data);
+/// @brief Converts the tree of root into an immutable CompactDocument, which
+/// can be shared by concurrent readers, e.g. after a QDomDocument has been
+/// loaded or constructed. Texts and CDATA sections are kept; comments and
+/// processing instructions are dropped.
+/// NOTE: root may not be used by other threads while it is being converted.
+CompactDocument freeze(const QDomElement & root);
+/// @brief Same as loadCompactDocument(filename), but keeps a binary snapshot
+/// of the parsed document and loads the snapshot instead of parsing the XML
+/// file when possible. The snapshot is keyed by the size and the
+/// modification time of the XML file. It is memory-mapped and copied into
+/// the document's arrays without any parsing. Stale or corrupt snapshots
+/// are ignored and replaced after the XML file is parsed. Failure to write
+/// a snapshot is not an error.
+/// @param cacheDirectory Directory for snapshots. If empty, the snapshot is
+/// stored next to the XML file as filename + ".xmlcache"; otherwise it is
+/// named after the hash of the absolute path of the XML file.
+/// @throw ReadError If the file could not be opened or parsed.
+CompactDocument loadCompactDocumentCached(
+    const QString & filename, const QString & cacheDirectory = QString());
+
+
+/// The following functions are the CompactElement overloads of XmlReading
+/// shortcuts. They behave exactly as the QDomElement versions.
+void assertTagName(const CompactElement & e, const QString & tagName);
+CompactElement getUniqueChild(const CompactElement & e,
+                              const QString & tagName);
+bool copyElementsAttributeTo(
+    const CompactElement & e, const QString & attributeName,
+    QString & destination);
+bool copyUniqueChildsTextTo(const CompactElement & e, const QString & tagName,
+                            QString & destination);
+bool copyUniqueChildsTextToByteArray(
+    const CompactElement & e, const QString & tagName,
+    QByteArray & destination);
+ReadStatus tryCopyUniqueChildsTextTo(
+    const CompactElement & e, const QString & tagName,
+    QString & destination) noexcept;
+template <class CompactElementCollection = std::vector<CompactElement>>
+CompactElementCollection getChildren(const CompactElement & e,
+                                     const QString & tagName);
+template <class TCollection, typename ElementToT>
+TCollection getChildren(const CompactElement & e, const QString & tagName,
+                        ElementToT childToResultValue);
+bool copyUniqueChildsStringListTo(
+    const CompactElement & e, const QString & listTagName,
+    const QString & stringTagName, QStringList & destination);
+
+} // END namespace XmlReading
+} // END namespace QtUtilities
+
+# include "../../src/CompactDocument-inl.hpp"
+
+# endif // QT_XML_UTILITIES_COMPACT_DOCUMENT_HPP
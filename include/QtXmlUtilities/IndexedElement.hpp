@@ -0,0 +1,124 @@
+/*
+ This file is part of vedgTools/QtXmlUtilities.
+ Copyright (C) 2014, 2015 Igor Kushnir <igorkuo AT Google mail>
+
+ vedgTools/QtXmlUtilities is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ vedgTools/QtXmlUtilities is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ vedgTools/QtXmlUtilities.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# ifndef QT_XML_UTILITIES_INDEXED_ELEMENT_HPP
+# define QT_XML_UTILITIES_INDEXED_ELEMENT_HPP
+
+# include <QtXmlUtilities/ReadingShortcuts.hpp>
+# include <QtXmlUtilities/ReadResult.hpp>
+# include <QtXmlUtilities/ChildRange.hpp>
+
+# include <QtGlobal>
+# include <QString>
+# include <QHash>
+# include <QDomElement>
+
+# include <vector>
+# include <type_traits>
+
+
+QT_FORWARD_DECLARE_CLASS(QByteArray)
+QT_FORWARD_DECLARE_CLASS(QStringList)
+
+namespace QtUtilities
+{
+namespace XmlReading
+{
+/// @brief Wraps QDomElement and indexes its children by tag name in a single
+/// pass. XmlReading shortcuts, which take IndexedElement, find a child and
+/// check its uniqueness in O(1) instead of scanning all children of the
+/// element.
+/// NOTE: the index is not updated if children of the element are changed.
+class IndexedElement
+{
+public:
+    explicit IndexedElement(const QDomElement & element);
+
+    const QDomElement & element() const { return element_; }
+
+    /// @return First child with name=tagName. If such a child does not exist,
+    /// returns null element.
+    QDomElement firstChildElement(const QString & tagName) const {
+        return children_.value(tagName).first;
+    }
+    /// @return Number of children with name=tagName.
+    int childCount(const QString & tagName) const {
+        return children_.value(tagName).count;
+    }
+
+private:
+    struct Children {
+        Children() : count(0) {}
+
+        QDomElement first;
+        int count;
+    };
+
+    QDomElement element_;
+    QHash<QString, Children> children_;
+};
+
+template <>
+struct IsElement<IndexedElement> : std::true_type {};
+
+
+/// @brief Same as getUniqueChild(e.element(), tagName), but O(1).
+QDomElement getUniqueChild(const IndexedElement & e, const QString & tagName);
+
+bool copyElementsAttributeTo(
+    const IndexedElement & e, const QString & attributeName,
+    QString & destination);
+
+bool copyUniqueChildsTextTo(const IndexedElement & e, const QString & tagName,
+                            QString & destination);
+bool copyUniqueChildsTextToByteArray(
+    const IndexedElement & e, const QString & tagName,
+    QByteArray & destination);
+/// @brief Non-throwing counterpart of copyUniqueChildsTextTo(e, tagName,
+/// destination).
+ReadStatus tryCopyUniqueChildsTextTo(
+    const IndexedElement & e, const QString & tagName,
+    QString & destination) noexcept;
+
+/// @brief Same as getChildren(e.element(), tagName), but starts at the first
+/// matching child and reserves space in the collection in advance.
+template <class QDomElementCollection = std::vector<QDomElement>>
+QDomElementCollection getChildren(const IndexedElement & e,
+                                  const QString & tagName);
+template <class TCollection, typename ElementToT>
+TCollection getChildren(const IndexedElement & e, const QString & tagName,
+                        ElementToT childToResultValue);
+
+/// @brief Same as children(e.element(), tagName), but starts at the first
+/// matching child in O(1).
+inline ChildRange<QString> children(const IndexedElement & e,
+                                    const QString & tagName)
+{
+    return ChildRange<QString>(e.firstChildElement(tagName), tagName);
+}
+
+bool copyUniqueChildsStringListTo(
+    const IndexedElement & e, const QString & listTagName,
+    const QString & stringTagName, QStringList & destination);
+
+} // END namespace XmlReading
+} // END namespace QtUtilities
+
+# include "../../src/IndexedElement-inl.hpp"
+
+# endif // QT_XML_UTILITIES_INDEXED_ELEMENT_HPP
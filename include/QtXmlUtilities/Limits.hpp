@@ -0,0 +1,102 @@
+/*
+ This file is part of vedgTools/QtXmlUtilities.
+ Copyright (C) 2014, 2015 Igor Kushnir <igorkuo AT Google mail>
+
+ vedgTools/QtXmlUtilities is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ vedgTools/QtXmlUtilities is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ vedgTools/QtXmlUtilities.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# ifndef QT_XML_UTILITIES_LIMITS_HPP
+# define QT_XML_UTILITIES_LIMITS_HPP
+
+# include <QtXmlUtilities/ReadingShortcuts.hpp>
+
+# include <QtGlobal>
+
+
+QT_FORWARD_DECLARE_CLASS(QByteArray)
+QT_FORWARD_DECLARE_CLASS(QIODevice)
+QT_FORWARD_DECLARE_CLASS(QString)
+QT_FORWARD_DECLARE_CLASS(QDomElement)
+
+namespace QtUtilities
+{
+namespace XmlReading
+{
+/// @brief Resource limits for parsing untrusted documents. Each limit is
+/// checked while the document is being parsed, so parsing stops as soon as
+/// a limit is exceeded. A value of 0 means no limit.
+struct Limits {
+    Limits()
+        : maxInputBytes(0), maxDepth(0), maxElementCount(0),
+          maxTextLength(0), maxAttributeLength(0) {
+    }
+
+    /// @return true if no limit is set.
+    bool isUnlimited() const {
+        return maxInputBytes == 0 && maxDepth == 0 && maxElementCount == 0 &&
+               maxTextLength == 0 && maxAttributeLength == 0;
+    }
+
+    /// Maximum number of (decompressed) bytes read from the input.
+    qint64 maxInputBytes;
+    /// Maximum nesting depth of elements; the root element has depth 1.
+    int maxDepth;
+    /// Maximum number of elements in the document.
+    qint64 maxElementCount;
+    /// Maximum total length of text directly inside a single element, in
+    /// UTF-16 code units. Text segments separated by child elements are
+    /// summed.
+    int maxTextLength;
+    /// Maximum length of a single attribute value, in UTF-16 code units.
+    int maxAttributeLength;
+};
+
+/// @brief Is thrown when a document exceeds one of the Limits.
+class LimitExceededError : public ReadError
+{
+public:
+    enum Limit { InputBytes, Depth, ElementCount, TextLength, AttributeLength };
+
+    LimitExceededError(Limit limit, qint64 maxValue, const QString & sWhat)
+        : ReadError(sWhat), limit_(limit), maxValue_(maxValue) {}
+    COPYABLE_AND_MOVABLE(LimitExceededError)
+    ~LimitExceededError() noexcept override;
+
+    /// @return The limit that was exceeded.
+    Limit limit() const { return limit_; }
+    /// @return Value of the exceeded limit.
+    qint64 maxValue() const { return maxValue_; }
+
+private:
+    Limit limit_;
+    qint64 maxValue_;
+};
+
+/// @brief Same as loadRoot(filename), but enforces limits while parsing.
+/// gzip-compressed files are supported; maxInputBytes applies to the
+/// decompressed data.
+/// NOTE: if limits.isUnlimited(), the document is loaded by loadRoot();
+/// otherwise it is parsed by QXmlStreamReader, which is somewhat slower than
+/// QDomDocument::setContent().
+/// @throw LimitExceededError If a limit is exceeded.
+QDomElement loadRoot(const QString & filename, const Limits & limits);
+/// @brief Same as loadRoot(device), but enforces limits while parsing.
+QDomElement loadRoot(QIODevice & device, const Limits & limits);
+/// @brief Same as loadRootFromData(data), but enforces limits while parsing.
+QDomElement loadRootFromData(const QByteArray & data, const Limits & limits);
+
+} // END namespace XmlReading
+} // END namespace QtUtilities
+
+# endif // QT_XML_UTILITIES_LIMITS_HPP
@@ -0,0 +1,160 @@
+/*
+ This file is part of vedgTools/QtXmlUtilities.
+ Copyright (C) 2014, 2015 Igor Kushnir <igorkuo AT Google mail>
+
+ vedgTools/QtXmlUtilities is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ vedgTools/QtXmlUtilities is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ vedgTools/QtXmlUtilities.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# ifndef QT_XML_UTILITIES_PARALLEL_READING_HPP
+# define QT_XML_UTILITIES_PARALLEL_READING_HPP
+
+# include <QtXmlUtilities/ReadingShortcuts.hpp>
+
+# include <QtGlobal>
+# include <QByteArray>
+# include <QDomElement>
+
+# include <exception>
+# include <utility>
+# include <type_traits>
+# include <vector>
+
+
+QT_FORWARD_DECLARE_CLASS(QString)
+QT_FORWARD_DECLARE_CLASS(QStringList)
+QT_FORWARD_DECLARE_CLASS(QThreadPool)
+
+namespace QtUtilities
+{
+namespace XmlReading
+{
+/// @brief Result of loading and converting a single document in parallel.
+template <typename T>
+struct LoadResult {
+    /// @brief Rethrows error if it is not null.
+    void rethrowError() const {
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    /// Holds the exception (normally ReadError) thrown while loading or
+    /// converting the document; is null in case of success.
+    std::exception_ptr error;
+    /// Result of the conversion; is value-initialized if error is not null.
+    T value;
+};
+
+namespace detail
+{
+/// @brief Type of value returned by Converter for a QDomElement.
+template <typename Converter>
+using ConverterResult = typename std::decay<decltype(
+    std::declval<Converter &>()(std::declval<const QDomElement &>()))>::type;
+
+/// @brief Document split into chunks of its top-level (depth 1) elements.
+/// Each chunk is a well-formed document, which consists of everything before
+/// the end of the root start tag, a range of top-level elements and the root
+/// end tag. Boundaries are found by a cheap byte-level prescan. If data can
+/// not be split (e.g. because of a non-ASCII-compatible encoding or a syntax
+/// error), there is a single chunk equal to data.
+class RecordChunks
+{
+public:
+    /// @param maxChunkCount Maximum number of chunks to split data into.
+    RecordChunks(const QByteArray & data, int maxChunkCount);
+
+    int count() const { return int(ranges_.size()); }
+    /// @brief Parses chunk specified by index.
+    /// @return Root element of the chunk.
+    /// @throw ReadError In case of parsing error.
+    QDomElement loadChunk(int index) const;
+
+private:
+    QByteArray data_;
+    QByteArray prefix_, suffix_;
+    /// Byte ranges of data_, which contain top-level elements of each chunk.
+    std::vector<std::pair<int, int>> ranges_;
+};
+
+/// @return Maximum number of chunks for parsing data of size dataSize in
+/// pool.
+int maxChunkCount(const QThreadPool & pool, int dataSize);
+
+/// @return Contents of the file specified by filename.
+/// @throw ReadError If the file could not be opened or read.
+QByteArray readFile(const QString & filename);
+
+} // END namespace detail
+
+/// @brief Calls loadRoot(filename, tagName) for each filename in filenames
+/// concurrently on the calling thread and on idle threads of pool, converts
+/// each root element with converter on the same thread and collects the
+/// results in the order of filenames.
+/// @tparam Converter Must be a callable object that takes a single parameter
+/// of type (const QDomElement &). It is called concurrently from several
+/// threads. The value it returns must not refer to the document (QDomNode
+/// handles are not thread-safe).
+/// @param pool If nullptr, QThreadPool::globalInstance() is used.
+/// @return One LoadResult per filename. Errors do not interrupt loading of
+/// other files.
+template <typename Converter>
+std::vector<LoadResult<detail::ConverterResult<Converter>>> loadRoots(
+            const QStringList & filenames, const QString & tagName,
+            Converter converter, QThreadPool * pool = nullptr);
+
+
+/// @brief Parses a single large document on the calling thread and on idle
+/// threads of pool. Top-level (depth 1) elements of the root are divided
+/// into chunks, which are parsed concurrently. Once all chunks have been
+/// parsed, children of the root with name=childTagName are converted with
+/// converter concurrently, chunk by chunk. Results are returned in document
+/// order. If a chunk fails to
+/// parse, the whole document is parsed sequentially, so that the error
+/// message reports the correct line and column; converter is called only
+/// once for each child in either case.
+/// NOTE: data must be in UTF-8 or another ASCII-compatible encoding to be
+/// split; otherwise it is parsed sequentially.
+/// @tparam Converter Same requirements as for loadRoots(). It is copied for
+/// each chunk.
+/// @param pool If nullptr, QThreadPool::globalInstance() is used.
+/// @throw ReadError If data could not be parsed or root's name does not
+/// match rootTagName. Exceptions thrown by converter are propagated.
+template <typename Converter>
+std::vector<detail::ConverterResult<Converter>> loadChildrenParallelFromData(
+            const QByteArray & data, const QString & rootTagName,
+            const QString & childTagName, Converter converter,
+            QThreadPool * pool = nullptr);
+/// @brief Same as above, but returns the children themselves. Each of them
+/// belongs to the document of its chunk.
+std::vector<QDomElement> loadChildrenParallelFromData(
+    const QByteArray & data, const QString & rootTagName,
+    const QString & childTagName, QThreadPool * pool = nullptr);
+
+/// @brief Same as loadChildrenParallelFromData(), but reads data from file
+/// specified by filename.
+template <typename Converter>
+std::vector<detail::ConverterResult<Converter>> loadChildrenParallel(
+            const QString & filename, const QString & rootTagName,
+            const QString & childTagName, Converter converter,
+            QThreadPool * pool = nullptr);
+std::vector<QDomElement> loadChildrenParallel(
+    const QString & filename, const QString & rootTagName,
+    const QString & childTagName, QThreadPool * pool = nullptr);
+
+} // END namespace XmlReading
+} // END namespace QtUtilities
+
+# include "../../src/ParallelReading-inl.hpp"
+
+# endif // QT_XML_UTILITIES_PARALLEL_READING_HPP
@@ -0,0 +1,113 @@
+/*
+ This file is part of vedgTools/QtXmlUtilities.
+ Copyright (C) 2014, 2015 Igor Kushnir <igorkuo AT Google mail>
+
+ vedgTools/QtXmlUtilities is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ vedgTools/QtXmlUtilities is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ vedgTools/QtXmlUtilities.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# ifndef QT_XML_UTILITIES_PATH_QUERY_HPP
+# define QT_XML_UTILITIES_PATH_QUERY_HPP
+
+# include <QtXmlUtilities/ReadingShortcuts.hpp>
+
+# include <QString>
+
+# include <cstddef>
+# include <vector>
+
+
+namespace QtUtilities
+{
+namespace XmlReading
+{
+class StreamReader;
+
+/// @brief Path expression, which is parsed once and then evaluated against
+/// any number of elements. Syntax:
+/// @code
+/// path  ::= [step {"/" step}] ["@" attributeName]
+/// step  ::= tagName ["[" n "]"]
+/// @endcode
+/// A step without an index selects the unique child with name=tagName and
+/// throws ReadError if there is more than one, exactly as getUniqueChild().
+/// A step with index n (1-based, as in XPath) selects the n-th child with
+/// name=tagName without checking uniqueness. A trailing "@attributeName"
+/// selects an attribute of the last element instead of its text.
+/// For example: "settings/network/proxy@port", "servers/server[2]/name".
+class PathQuery
+{
+public:
+    /// @throw ReadError If path is not a valid path expression.
+    explicit PathQuery(const QString & path);
+
+    const QString & path() const { return path_; }
+    /// @return true if the path ends with "@attributeName".
+    bool hasAttribute() const { return ! attribute_.isEmpty(); }
+
+    /// @return Element selected by the steps of the path (ignoring the
+    /// attribute part) or null element if some step does not match.
+    /// @tparam TElement QDomElement, CompactElement or another element type
+    /// with QDomElement-like firstChildElement(tagName) and
+    /// nextSiblingElement(tagName) methods.
+    /// @throw ReadError If a step without an index matches more than one
+    /// child.
+    template <class TElement>
+    TElement element(const TElement & e) const;
+
+    /// @brief If the path matches, copies the selected text or attribute value
+    /// to destination; otherwise destination is not changed.
+    /// @return true if the value was copied to destination.
+    /// @throw ReadError If a step without an index matches more than one
+    /// child.
+    template <class TElement>
+    bool copyTo(const TElement & e, QString & destination) const;
+    /// @brief Same as above, but converts the value to type T.
+    /// @tparam T There must be a ConvertQString::to<T> specialization.
+    template <typename T, class TElement>
+    bool copyTo(const TElement & e, T & destination) const;
+
+    /// @brief Same as copyTo(), but evaluates the path against the children
+    /// of reader's current element in a single forward pass. Moves past the
+    /// end of the current element. Uniqueness of all steps is verified, so
+    /// the rest of the element is scanned even after the value was found.
+    bool read(StreamReader & reader, QString & destination) const;
+    template <typename T>
+    bool read(StreamReader & reader, T & destination) const;
+
+private:
+    struct Step {
+        QString tagName;
+        /// 0 if the child must be unique; otherwise 1-based index.
+        int index;
+    };
+
+    /// @brief Evaluates steps_[stepIndex, end) against reader's current
+    /// element.
+    bool readFrom(StreamReader & reader, std::size_t stepIndex,
+                  QString & destination) const;
+    /// @brief Converts value selected by this path to type T.
+    template <typename T>
+    T convert(const QString & value) const;
+
+    QString path_;
+    std::vector<Step> steps_;
+    QString attribute_;
+};
+
+} // END namespace XmlReading
+} // END namespace QtUtilities
+
+# include "../../src/PathQuery-inl.hpp"
+
+# endif // QT_XML_UTILITIES_PATH_QUERY_HPP
@@ -0,0 +1,140 @@
+/*
+ This file is part of vedgTools/QtXmlUtilities.
+ Copyright (C) 2014, 2015 Igor Kushnir <igorkuo AT Google mail>
+
+ vedgTools/QtXmlUtilities is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ vedgTools/QtXmlUtilities is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ vedgTools/QtXmlUtilities.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# ifndef QT_XML_UTILITIES_READ_RESULT_HPP
+# define QT_XML_UTILITIES_READ_RESULT_HPP
+
+# include <QtXmlUtilities/ReadingShortcuts.hpp>
+
+# include <QString>
+# include <QDomElement>
+
+
+namespace QtUtilities
+{
+namespace XmlReading
+{
+/// @brief Result of a non-throwing shortcut. Holds an error code and the name
+/// of the element or attribute, which the code refers to. Human-readable text
+/// is built only when message() is called.
+class ReadStatus
+{
+public:
+    enum Code : unsigned char {
+        /// The value was copied to destination.
+        Ok,
+        /// The element or attribute does not exist; destination was not
+        /// changed. This is not an error.
+        Absent,
+        /// More than one child element with the name exists.
+        NotUnique,
+        /// The text could not be converted to the destination type.
+        ConversionFailed,
+        /// The converted value was rejected by the validator.
+        ValidationFailed
+    };
+
+    ReadStatus() noexcept : code_(Ok), isAttribute_(false) {}
+    ReadStatus(Code code, const QString & name, bool isAttribute) noexcept
+        : name_(name), code_(code), isAttribute_(isAttribute) {}
+
+    Code code() const noexcept { return code_; }
+    /// @return true if the value was copied to destination.
+    bool ok() const noexcept { return code_ == Ok; }
+    /// @return true if reading failed, i.e. the code is neither Ok nor Absent.
+    bool isError() const noexcept { return code_ > Absent; }
+
+    /// @return Name of the element or attribute. Empty if the code is Ok.
+    const QString & name() const noexcept { return name_; }
+    /// @return true if name() is the name of an attribute.
+    bool isAttribute() const noexcept { return isAttribute_; }
+
+    /// @return Description of the error in the same wording as the messages
+    /// of ReadError thrown by the throwing shortcuts. Empty if ! isError().
+    QString message() const;
+    /// @throw ReadError With message() if isError().
+    void throwIfError() const;
+
+private:
+    QString name_;
+    Code code_;
+    bool isAttribute_;
+};
+
+
+/// @brief Non-throwing counterparts of the XmlReading shortcuts for hot
+/// paths, where malformed values are common. These functions never throw and
+/// never format messages: failures are reported as ReadStatus. destination
+/// is changed only if the returned status is Ok.
+/// Conversion of arithmetic types is done by QString::toInt() and similar
+/// functions without throwing; other types are converted by
+/// ConvertQString::to<T>, whose StringError is caught.
+/// Validators of the non-throwing API are predicates: a validator must
+/// return true for valid values instead of throwing.
+
+/// @brief Same as getUniqueChild(e, tagName), but reports NotUnique instead
+/// of throwing. destination is set to the child if the status is Ok.
+ReadStatus tryGetUniqueChild(const QDomElement & e, const QString & tagName,
+                             QDomElement & destination) noexcept;
+
+ReadStatus tryCopyUniqueChildsTextTo(
+    const QDomElement & e, const QString & tagName,
+    QString & destination) noexcept;
+template <typename T, class TElement>
+ReadStatus tryCopyUniqueChildsTextTo(
+    const TElement & e, const QString & tagName, T & destination) noexcept;
+/// @param isValid Predicate, which is called with the converted value.
+template <typename T, typename Predicate, class TElement>
+ReadStatus tryCopyUniqueChildsTextTo(
+    const TElement & e, const QString & tagName, T & destination,
+    Predicate isValid) noexcept;
+
+/// @brief Validates that value >= minValue.
+template <typename T, class TElement>
+ReadStatus tryCopyUniqueChildsTextToMin(
+    const TElement & e, const QString & tagName, T & destination,
+    const T & minValue) noexcept;
+/// @brief Validates that value <= maxValue.
+template <typename T, class TElement>
+ReadStatus tryCopyUniqueChildsTextToMax(
+    const TElement & e, const QString & tagName, T & destination,
+    const T & maxValue) noexcept;
+/// @brief Validates that minValue <= value <= maxValue.
+template <typename T, class TElement>
+ReadStatus tryCopyUniqueChildsTextToRange(
+    const TElement & e, const QString & tagName, T & destination,
+    const T & minValue, const T & maxValue) noexcept;
+/// @brief Validates that value == 0 or minValue <= value <= maxValue.
+template <typename T, class TElement>
+ReadStatus tryCopyUniqueChildsTextToRange0Allowed(
+    const TElement & e, const QString & tagName, T & destination,
+    const T & minValue, const T & maxValue) noexcept;
+
+/// @brief Same as copyElementsAttributeTo<T>, but reports ConversionFailed
+/// instead of throwing.
+template <typename T, class TElement>
+ReadStatus tryCopyElementsAttributeTo(
+    const TElement & e, const QString & attributeName,
+    T & destination) noexcept;
+
+} // END namespace XmlReading
+} // END namespace QtUtilities
+
+# include "../../src/ReadResult-inl.hpp"
+
+# endif // QT_XML_UTILITIES_READ_RESULT_HPP
@@ -19,17 +19,22 @@
 # ifndef QT_XML_UTILITIES_READING_SHORTCUTS_HPP
 # define QT_XML_UTILITIES_READING_SHORTCUTS_HPP
 
+# include <QtXmlUtilities/Binary.hpp>
+
 # include <QtCoreUtilities/Error.hpp>
 
 # include <CommonUtilities/CopyAndMoveSemantics.hpp>
 
 # include <QtGlobal>
+# include <QLatin1String>
 # include <QDomElement>
 
 # include <vector>
+# include <type_traits>
 
 
 QT_FORWARD_DECLARE_CLASS(QByteArray)
+QT_FORWARD_DECLARE_CLASS(QIODevice)
 QT_FORWARD_DECLARE_CLASS(QString)
 QT_FORWARD_DECLARE_CLASS(QStringList)
 
@@ -47,15 +52,49 @@ public:
     ~ReadError() noexcept override;
 };
 
+/// @brief Is derived from std::true_type for element types, which can be
+/// passed as TElement to the templated shortcuts. Such a type must have
+/// non-template overloads of copyElementsAttributeTo(e, attributeName,
+/// QString &) and copyUniqueChildsTextTo(e, tagName, QString &), and of
+/// tryCopyUniqueChildsTextTo(e, tagName, QString &) (see ReadResult.hpp).
+template <class TElement>
+struct IsElement : std::false_type {};
+template <>
+struct IsElement<QDomElement> : std::true_type {};
+
 /// @throw ReadError If e's name does not match tagName.
 void assertTagName(const QDomElement & e, const QString & tagName);
 
 /// @brief Loads document from file specified by filename and returns its
 /// root element.
+/// If the file starts with gzip magic bytes, it is decompressed on the fly,
+/// without an intermediate uncompressed copy. Throws ReadError in this case
+/// if the library is built without zlib (QT_XML_UTILITIES_WITH_ZLIB).
 QDomElement loadRoot(const QString & filename);
 /// @brief This is an overloaded function. After extracting root element this
 /// function calls assertTagName(root, tagName) if (! root.isNull()).
 QDomElement loadRoot(const QString & filename, const QString & tagName);
+/// @brief Loads document from device and returns its root element.
+/// device is opened for reading if it is not open yet.
+QDomElement loadRoot(QIODevice & device);
+/// @brief This is an overloaded function. After extracting root element this
+/// function calls assertTagName(root, tagName) if (! root.isNull()).
+QDomElement loadRoot(QIODevice & device, const QString & tagName);
+/// @brief Loads document from data and returns its root element.
+/// NOTE: this function is not an overload of loadRoot() because string
+/// literals are implicitly convertible both to QString and QByteArray.
+QDomElement loadRootFromData(const QByteArray & data);
+/// @brief This is an overloaded function. After extracting root element this
+/// function calls assertTagName(root, tagName) if (! root.isNull()).
+QDomElement loadRootFromData(const QByteArray & data, const QString & tagName);
+/// @brief Same as loadRoot(filename), but maps the file into memory and
+/// parses the mapped pages directly instead of reading the file into an
+/// intermediate buffer. Falls back to reading if the file can not be mapped.
+/// gzip-compressed files are decompressed on the fly as in loadRoot().
+QDomElement loadRootMapped(const QString & filename);
+/// @brief This is an overloaded function. After extracting root element this
+/// function calls assertTagName(root, tagName) if (! root.isNull()).
+QDomElement loadRootMapped(const QString & filename, const QString & tagName);
 
 
 /// @return Child of e with name=tagName.
@@ -73,10 +112,13 @@ bool copyElementsAttributeTo(
 /// If a value was received, converts the value to type T and stores it in
 /// destination; otherwise destination is not changed.
 /// @tparam T There must be a ConvertQString::to<T> specialization.
+/// @tparam TElement QDomElement or another type, for which IsElement is
+/// specialized (e.g. IndexedElement). This applies to all templated shortcuts
+/// below that take TElement.
 /// @return true if converted value was copied to destination.
-template <typename T>
+template <typename T, class TElement>
 bool copyElementsAttributeTo(
-    const QDomElement & e, const QString & attributeName, T & destination);
+    const TElement & e, const QString & attributeName, T & destination);
 
 /// @brief Calls getUniqueChild(e, tagName). If result is not a null element,
 /// copies its text to destination; otherwise destination is not changed.
@@ -88,13 +130,23 @@ bool copyUniqueChildsTextTo(const QDomElement & e, const QString & tagName,
 /// otherwise destination is not changed.
 /// @tparam T There must be a ConvertQString::to<T> specialization.
 /// @return true if converted text was copied to destination.
-template <typename T>
-bool copyUniqueChildsTextTo(const QDomElement & e, const QString & tagName,
+template <typename T, class TElement>
+bool copyUniqueChildsTextTo(const TElement & e, const QString & tagName,
                             T & destination);
 /// @brief Identical to template copyUniqueChildsTextTo<T> but uses
 /// qStringtoByteArray itstead of ConvertQString::to<T>.
 bool copyUniqueChildsTextToByteArray(
     const QDomElement & e, const QString & tagName, QByteArray & destination);
+/// @brief Calls copyUniqueChildsTextTo(e, tagName, <temporary_string>).
+/// If text was received, decodes it from encoding (see Binary.hpp) straight
+/// into destination, which is allocated once; otherwise destination is not
+/// changed. This is the inverse of XmlWriting::createElementFromBinary().
+/// @throw ReadError If the text is not valid in encoding.
+/// @return true if decoded data was copied to destination.
+template <class TElement>
+bool copyUniqueChildsBinaryTo(
+    const TElement & e, const QString & tagName, QByteArray & destination,
+    BinaryEncoding encoding = BinaryEncoding::Base64);
 
 /// @tparam QDomElementCollection back() const and
 /// push_back([const] QDomElement [&[&]] [or implicitly convertible from])
@@ -103,8 +155,13 @@ bool copyUniqueChildsTextToByteArray(
 template <class QDomElementCollection = std::vector<QDomElement>>
 QDomElementCollection getChildren(const QDomElement & e,
                                   const QString & tagName);
-/// @brief Calls getChildren(e, tagName), converts children to type T using
+/// @brief Converts e's children with name=tagName to type T using
 /// function childToResultValue and returns result of the conversion.
+/// Children are converted as they are found in a single pass, without an
+/// intermediate collection. The number of children is not known in advance,
+/// so no space is reserved; use the IndexedElement overload, which knows it,
+/// to avoid reallocations. See also children() in ChildRange.hpp for a lazy
+/// alternative.
 /// @tparam TCollection Must have push_back([const] T [&[&]]  [or implicitly
 /// convertible from]) method; iterators.
 /// @tparam ElementToT Must be a callable object that takes a single parameter
@@ -119,27 +176,29 @@ TCollection getChildren(const QDomElement & e, const QString & tagName,
 /// If destination was set, calls validator(destination) and returns true;
 /// otherwise returns false.
 /// @throw ReadError If calling validator throws Error.
-template <typename T, typename Validator>
-bool copyUniqueChildsTextTo(const QDomElement & e, const QString & tagName,
+/// @tparam TString QString or QLatin1String. This applies to all templated
+/// shortcuts below that take TString.
+template <typename T, typename Validator, class TElement, class TString>
+bool copyUniqueChildsTextTo(const TElement & e, const TString & tagName,
                             T & destination, Validator validator);
 
 /// @brief Calls copyUniqueChildsTextTo with validator=checkMinValue.
-template <typename T>
-bool copyUniqueChildsTextToMin(const QDomElement & e, const QString & tagName,
+template <typename T, class TElement, class TString>
+bool copyUniqueChildsTextToMin(const TElement & e, const TString & tagName,
                                T & destination, const T & minValue);
 /// @brief Calls copyUniqueChildsTextTo with validator=checkMaxValue.
-template <typename T>
-bool copyUniqueChildsTextToMax(const QDomElement & e, const QString & tagName,
+template <typename T, class TElement, class TString>
+bool copyUniqueChildsTextToMax(const TElement & e, const TString & tagName,
                                T & destination, const T & maxValue);
 /// @brief Calls copyUniqueChildsTextTo with validator=checkRange.
-template <typename T>
+template <typename T, class TElement, class TString>
 bool copyUniqueChildsTextToRange(
-    const QDomElement & e, const QString & tagName,
+    const TElement & e, const TString & tagName,
     T & destination, const T & minValue, const T & maxValue);
 /// @brief Calls copyUniqueChildsTextTo with validator=checkRange0Allowed.
-template <typename T>
+template <typename T, class TElement, class TString>
 bool copyUniqueChildsTextToRange0Allowed(
-    const QDomElement & e, const QString & tagName,
+    const TElement & e, const TString & tagName,
     T & destination, const T & minValue, const T & maxValue);
 
 
@@ -153,6 +212,31 @@ bool copyUniqueChildsStringListTo(
     const QDomElement & e, const QString & listTagName,
     const QString & stringTagName, QStringList & destination);
 
+
+/// The following overloads take tag names as QLatin1String. Unlike the
+/// QString overloads, they do not allocate a QString for each tag name passed
+/// as a string literal, which matters in tight loops. For example:
+/// copyUniqueChildsTextTo(e, QLatin1String("size"), size).
+/// NOTE: QDomElement can only look up children by QString, so these overloads
+/// compare the names of children while iterating over them instead.
+void assertTagName(const QDomElement & e, QLatin1String tagName);
+QDomElement getUniqueChild(const QDomElement & e, QLatin1String tagName);
+bool copyUniqueChildsTextTo(const QDomElement & e, QLatin1String tagName,
+                            QString & destination);
+template <typename T>
+bool copyUniqueChildsTextTo(const QDomElement & e, QLatin1String tagName,
+                            T & destination);
+bool copyUniqueChildsTextToByteArray(
+    const QDomElement & e, QLatin1String tagName, QByteArray & destination);
+template <class QDomElementCollection = std::vector<QDomElement>>
+QDomElementCollection getChildren(const QDomElement & e, QLatin1String tagName);
+template <class TCollection, typename ElementToT>
+TCollection getChildren(const QDomElement & e, QLatin1String tagName,
+                        ElementToT childToResultValue);
+bool copyUniqueChildsStringListTo(
+    const QDomElement & e, QLatin1String listTagName,
+    QLatin1String stringTagName, QStringList & destination);
+
 } // END namespace XmlReading
 } // END namespace QtUtilities
 
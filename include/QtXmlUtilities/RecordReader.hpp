@@ -0,0 +1,112 @@
+/*
+ This file is part of vedgTools/QtXmlUtilities.
+ Copyright (C) 2014, 2015 Igor Kushnir <igorkuo AT Google mail>
+
+ vedgTools/QtXmlUtilities is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ vedgTools/QtXmlUtilities is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ vedgTools/QtXmlUtilities.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# ifndef QT_XML_UTILITIES_RECORD_READER_HPP
+# define QT_XML_UTILITIES_RECORD_READER_HPP
+
+# include <QtXmlUtilities/ReadingShortcuts.hpp>
+
+# include <QtGlobal>
+# include <QString>
+# include <QXmlStreamReader>
+
+# include <memory>
+# include <functional>
+
+
+QT_FORWARD_DECLARE_CLASS(QByteArray)
+QT_FORWARD_DECLARE_CLASS(QIODevice)
+QT_FORWARD_DECLARE_CLASS(QDomElement)
+
+namespace QtUtilities
+{
+namespace XmlReading
+{
+struct Limits;
+
+namespace detail
+{
+class DomBuilder;
+class LimitChecker;
+}
+
+/// @brief Push parser for documents, which consist of many repeated record
+/// elements. XML data is fed in chunks of any size (e.g. as they arrive from
+/// a pipe or a socket); as soon as a record element is complete, it is built
+/// into a small self-contained QDomDocument and passed to the handler.
+/// Elements outside of records are not stored, so memory usage is bounded by
+/// the size of the largest record rather than by the size of the document.
+/// A record is an element with name=recordTagName that is not nested in
+/// another record; records may appear at any depth.
+/// @throw ReadError In case of parsing error.
+class RecordReader
+{
+public:
+    /// @brief Is called with the root element of each completed record.
+    /// XmlReading shortcuts can be used on it. The record's document is
+    /// released after the handler returns unless the handler keeps a copy of
+    /// the element.
+    typedef std::function<void (const QDomElement &)> Handler;
+
+    RecordReader(const QString & recordTagName, Handler handler);
+    ~RecordReader();
+
+    /// @brief Enforces limits (see Limits.hpp) on the whole data stream:
+    /// maxInputBytes applies to the total size of added data, maxElementCount
+    /// to all elements including those outside of records. Should be called
+    /// before the first addData() call.
+    void setLimits(const Limits & limits);
+
+    /// @brief Parses data and calls the handler for each record completed by
+    /// it. A record may span any number of chunks.
+    /// @throw ReadError If data is not well-formed XML. Exceptions thrown by
+    /// the handler are propagated. This reader must not be used after an
+    /// exception.
+    void addData(const QByteArray & data);
+    /// @brief Must be called after the last chunk of data has been added.
+    /// @throw ReadError If the document is incomplete.
+    void finish();
+
+    /// @brief Reads device in chunks of chunkSize bytes until its end, passing
+    /// each chunk to addData(), and calls finish().
+    /// device must be open for reading. For sockets and other asynchronous
+    /// devices call addData() from a readyRead() handler instead.
+    void readAll(QIODevice & device, qint64 chunkSize = 64 * 1024);
+
+    /// @return Number of records passed to the handler so far.
+    qint64 recordCount() const { return recordCount_; }
+
+private:
+    /// @brief Processes all tokens available in xml_.
+    void parseAvailable();
+    [[noreturn]] void throwError() const;
+
+    QString recordTagName_;
+    Handler handler_;
+    QXmlStreamReader xml_;
+    std::unique_ptr<detail::DomBuilder> builder_;
+    std::unique_ptr<detail::LimitChecker> limits_;
+    qint64 bytesAdded_;
+    bool inRecord_;
+    qint64 recordCount_;
+};
+
+} // END namespace XmlReading
+} // END namespace QtUtilities
+
+# endif // QT_XML_UTILITIES_RECORD_READER_HPP
@@ -0,0 +1,177 @@
+/*
+ This file is part of vedgTools/QtXmlUtilities.
+ Copyright (C) 2014, 2015 Igor Kushnir <igorkuo AT Google mail>
+
+ vedgTools/QtXmlUtilities is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ vedgTools/QtXmlUtilities is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ vedgTools/QtXmlUtilities.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# ifndef QT_XML_UTILITIES_STATISTICS_HPP
+# define QT_XML_UTILITIES_STATISTICS_HPP
+
+# include <QtGlobal>
+# include <QString>
+
+# include <atomic>
+# include <functional>
+
+
+QT_FORWARD_DECLARE_CLASS(QDomElement)
+
+/// @brief Optional instrumentation of XmlReading and XmlWriting hot paths.
+/// Statistics are disabled at run time by default; while disabled, each
+/// instrumented call costs a single relaxed atomic load. Defining
+/// QT_XML_UTILITIES_NO_STATISTICS makes isEnabled() a compile-time false,
+/// so the instrumentation is removed completely. The macro must be defined
+/// either for both the library and all its clients or for none of them
+/// because templated shortcuts are instrumented in headers. The
+/// QT_XML_UTILITIES_NO_STATISTICS CMake option defines it for the library
+/// and, via the target's public compile definitions, for its clients.
+/// All functions in this namespace are thread-safe.
+namespace QtUtilities
+{
+namespace XmlStatistics
+{
+enum class Counter
+{
+    /// loadRoot*() calls, including failed ones.
+    LoadCalls,
+    /// loadRoot*() calls that threw ReadError.
+    LoadFailures,
+    /// Input bytes of loadRoot*() calls with known input size.
+    LoadBytes,
+    /// Elements in successfully loaded documents.
+    LoadElements,
+    /// Time spent in loadRoot*() calls (reading and parsing are interleaved).
+    LoadNanoseconds,
+    /// save() and saveData() calls that wrote a file, including failed ones.
+    SaveCalls,
+    /// save() and saveData() calls that threw WriteError.
+    SaveFailures,
+    /// Size of successfully written files.
+    SaveBytes,
+    /// Time spent writing files in save() and saveData().
+    SaveNanoseconds,
+    /// getUniqueChild() and getChildren() calls on QDomElement,
+    /// IndexedElement and CompactElement, including calls made by other
+    /// shortcuts.
+    ChildLookups,
+    /// Child elements, whose names these lookups compared with the tag name.
+    /// An element found in the index of IndexedElement counts as one.
+    ScannedSiblings,
+    /// Failed conversions of element texts and attribute values.
+    ConversionFailures
+};
+constexpr int counterCount = int(Counter::ConversionFailures) + 1;
+
+/// @return Name of counter in camelCase, e.g. "loadBytes".
+const char * name(Counter counter);
+
+/// @brief Values of all counters at some point in time.
+struct Snapshot
+{
+    qint64 operator[](const Counter counter) const {
+        return values[int(counter)];
+    }
+
+    qint64 values[counterCount];
+};
+
+/// @brief Describes a single loadRoot*(), save() or saveData() call.
+struct Event
+{
+    enum Kind { Load, Save };
+
+    Kind kind;
+    /// Description of the source/destination, e.g. "file config.xml".
+    QString source;
+    /// Input/output size in bytes or -1 if unknown (sequential device).
+    qint64 bytes;
+    /// Number of elements in the loaded document or -1 for Save events and
+    /// failed loads.
+    qint64 elements;
+    qint64 nanoseconds;
+    bool succeeded;
+};
+
+/// @brief Is called synchronously in the thread, which has loaded or saved a
+/// document. Must not throw exceptions and should return quickly.
+using Observer = std::function<void (const Event &)>;
+
+
+namespace detail
+{
+extern std::atomic<bool> enabled;
+extern std::atomic<qint64> counters[counterCount];
+
+inline void add(const Counter counter, const qint64 value = 1) noexcept
+{
+    counters[int(counter)].fetch_add(value, std::memory_order_relaxed);
+}
+
+/// @brief Updates counters and notifies the observer about a load.
+/// @param root Loaded root element or nullptr if loading failed.
+void recordLoad(const QString & source, qint64 bytes,
+                const QDomElement * root, qint64 nanoseconds);
+/// @brief Updates counters and notifies the observer about a save.
+void recordSave(const QString & source, qint64 bytes, bool succeeded,
+                qint64 nanoseconds);
+/// @brief Records a child lookup, which has visited scanned child elements.
+inline void recordLookup(const qint64 scanned) noexcept
+{
+    add(Counter::ChildLookups);
+    add(Counter::ScannedSiblings, scanned);
+}
+
+} // END namespace detail
+
+
+/// @return true if statistics are being collected.
+inline bool isEnabled() noexcept
+{
+# ifdef QT_XML_UTILITIES_NO_STATISTICS
+    return false;
+# else
+    return detail::enabled.load(std::memory_order_relaxed);
+# endif
+}
+namespace detail
+{
+/// @brief Increments counter if statistics are enabled.
+inline void count(const Counter counter) noexcept
+{
+    if (isEnabled())
+        add(counter);
+}
+
+} // END namespace detail
+
+/// @brief Starts or stops collecting statistics. Enabling statistics makes
+/// each load walk the loaded document once more to count its elements.
+/// Child lookups count the elements they visit as they search.
+void setEnabled(bool enable);
+
+/// @return Current values of all counters. Counters are read one by one, so
+/// the snapshot is not atomic with respect to concurrent updates.
+Snapshot snapshot();
+/// @brief Sets all counters to 0.
+void reset();
+
+/// @brief Replaces the observer, which is notified about each load and save
+/// while statistics are enabled. Pass Observer() to remove the observer.
+void setObserver(Observer observer);
+
+} // END namespace XmlStatistics
+} // END namespace QtUtilities
+
+# endif // QT_XML_UTILITIES_STATISTICS_HPP
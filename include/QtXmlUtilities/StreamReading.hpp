@@ -0,0 +1,276 @@
+/*
+ This file is part of vedgTools/QtXmlUtilities.
+ Copyright (C) 2014, 2015 Igor Kushnir <igorkuo AT Google mail>
+
+ vedgTools/QtXmlUtilities is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ vedgTools/QtXmlUtilities is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ vedgTools/QtXmlUtilities.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# ifndef QT_XML_UTILITIES_STREAM_READING_HPP
+# define QT_XML_UTILITIES_STREAM_READING_HPP
+
+# include <QtXmlUtilities/ReadingShortcuts.hpp>
+
+# include <QtGlobal>
+# include <QString>
+# include <QLatin1String>
+# include <QStringList>
+# include <QHash>
+# include <QXmlStreamReader>
+
+# include <memory>
+# include <vector>
+# include <functional>
+
+
+QT_FORWARD_DECLARE_CLASS(QByteArray)
+QT_FORWARD_DECLARE_CLASS(QIODevice)
+QT_FORWARD_DECLARE_CLASS(QFile)
+
+namespace QtUtilities
+{
+namespace XmlReading
+{
+struct Limits;
+
+namespace detail
+{
+class LimitChecker;
+}
+
+/// @brief Forward-only XML reader, which never builds a DOM.
+/// At any moment the reader is positioned on its current element. Attributes
+/// of the current element can be read right away; its children are read in a
+/// single forward pass by readChildren() or ChildrenReader::read().
+/// @throw ReadError In case of parsing error.
+class StreamReader
+{
+public:
+    /// @brief Reads XML from device. device must be open for reading and
+    /// must outlive this reader.
+    explicit StreamReader(QIODevice & device);
+    /// @brief Opens file specified by filename and reads XML from it.
+    /// @throw ReadError If the file could not be opened.
+    explicit StreamReader(const QString & filename);
+
+    ~StreamReader();
+
+    /// @brief Enforces limits (see Limits.hpp) while reading the document.
+    /// Must be called before readRoot(). maxInputBytes is checked against
+    /// the position in the device or, for sequential devices, against the
+    /// number of characters read.
+    /// @throw LimitExceededError If the device's size is known and exceeds
+    /// limits.maxInputBytes. Reading methods throw LimitExceededError as
+    /// soon as a limit is exceeded.
+    void setLimits(const Limits & limits);
+
+    /// @return Underlying QXmlStreamReader for advanced use.
+    QXmlStreamReader & xml() { return xml_; }
+
+    /// @brief Moves to the root element of the document, which becomes the
+    /// current element.
+    /// @throw ReadError If the document has no root element.
+    void readRoot();
+    /// @brief This is an overloaded function. After moving to the root element
+    /// this function calls assertTagName(tagName).
+    void readRoot(const QString & tagName);
+
+    /// @return Name of the current element.
+    QString tagName() const { return xml_.name().toString(); }
+    /// @return true if the current element's name equals tagName.
+    bool hasTagName(const QString & tagName) const {
+        return xml_.name() == tagName;
+    }
+    bool hasTagName(QLatin1String tagName) const {
+        return xml_.name() == tagName;
+    }
+    /// @throw ReadError If the current element's name does not match tagName.
+    void assertTagName(const QString & tagName) const;
+
+    /// @brief If the current element has an attribute with the specified name,
+    /// copies the attribute's value to destination; otherwise destination is
+    /// not changed. Must be called before any child of the current element is
+    /// read.
+    /// @return true if attribute's value was copied to destination.
+    bool copyElementsAttributeTo(const QString & attributeName,
+                                 QString & destination) const;
+    /// @brief Same as XmlReading::copyElementsAttributeTo<T>, but for the
+    /// current element.
+    template <typename T>
+    bool copyElementsAttributeTo(const QString & attributeName,
+                                 T & destination) const;
+
+    /// @brief Reads text of the current element (including text of its
+    /// descendants, as QDomElement::text() does) and moves past its end.
+    QString readText();
+    /// @brief Decodes text of the current element from encoding (see
+    /// Binary.hpp) and moves past its end. Text tokens are decoded as they
+    /// are parsed, so the whole encoded text is never held in memory.
+    /// @throw ReadError If the text is not valid in encoding.
+    QByteArray readBinary(BinaryEncoding encoding = BinaryEncoding::Base64);
+    /// @brief Skips the rest of the current element.
+    void skipElement();
+
+    /// @brief Makes each child element of the current element the current
+    /// element in turn and calls handler(*this) for it. Children, which
+    /// handler does not read, are skipped. Moves past the end of the current
+    /// element.
+    /// @tparam ChildHandler Must be a callable object that takes a single
+    /// parameter of type (StreamReader &).
+    template <typename ChildHandler>
+    void readChildren(ChildHandler handler);
+
+private:
+    /// @brief Moves to the next child of the current element.
+    /// @return false if the end of the current element was reached.
+    bool readNextChild();
+    /// @brief Reads the next token and checks it against the limits.
+    QXmlStreamReader::TokenType readNextToken();
+    /// @brief Implementations of readText() and skipElement(), which pass
+    /// every token through readNextToken().
+    QString readTextChecked();
+    void skipElementChecked();
+    /// @throw ReadError If the underlying reader has encountered an error.
+    void checkError() const;
+    [[noreturn]] void throwError() const;
+
+    std::unique_ptr<QFile> file_;
+    QString filename_;
+    QXmlStreamReader xml_;
+    std::unique_ptr<detail::LimitChecker> limits_;
+};
+
+
+/// @brief Provides XmlReading shortcuts for the children of StreamReader's
+/// current element. Children of interest are registered with the shortcut
+/// methods first, then read() reads all of them in a single forward pass.
+/// Uniqueness checks and ReadError messages are the same as in the
+/// QDomElement-based shortcuts. Unique children are converted and validated
+/// only after the whole element has been read, and are assigned to their
+/// destinations only after all of them have been converted and validated,
+/// so destinations are not changed if read() throws. Handlers registered
+/// by getUniqueChild() and getChildren() are called during the pass.
+/// Each tag name may be registered only once: the registration methods throw
+/// Error if tagName (listTagName) is already registered.
+/// NOTE: registered destinations (and validators) must stay alive until
+/// read() returns.
+class ChildrenReader
+{
+public:
+    /// @brief Registers unique child with name=tagName. If it is found, its
+    /// text is copied to destination; otherwise destination is not changed.
+    void copyUniqueChildsTextTo(const QString & tagName, QString & destination);
+    /// @brief Same as above, but converts text to type T.
+    /// @tparam T There must be a ConvertQString::to<T> specialization.
+    template <typename T>
+    void copyUniqueChildsTextTo(const QString & tagName, T & destination);
+    /// @brief Same as above, but calls validator(destination) after
+    /// conversion.
+    template <typename T, typename Validator>
+    void copyUniqueChildsTextTo(const QString & tagName, T & destination,
+                                Validator validator);
+    /// @brief Identical to template copyUniqueChildsTextTo<T> but uses
+    /// qStringtoByteArray itstead of ConvertQString::to<T>.
+    void copyUniqueChildsTextToByteArray(const QString & tagName,
+                                         QByteArray & destination);
+    /// @brief Registers unique child with name=tagName. If it is found, its
+    /// text is decoded from encoding by StreamReader::readBinary() and
+    /// assigned to destination; otherwise destination is not changed.
+    void copyUniqueChildsBinaryTo(
+        const QString & tagName, QByteArray & destination,
+        BinaryEncoding encoding = BinaryEncoding::Base64);
+
+    /// @brief Calls copyUniqueChildsTextTo with validator=checkMinValue.
+    template <typename T>
+    void copyUniqueChildsTextToMin(const QString & tagName, T & destination,
+                                   T minValue);
+    /// @brief Calls copyUniqueChildsTextTo with validator=checkMaxValue.
+    template <typename T>
+    void copyUniqueChildsTextToMax(const QString & tagName, T & destination,
+                                   T maxValue);
+    /// @brief Calls copyUniqueChildsTextTo with validator=checkRange.
+    template <typename T>
+    void copyUniqueChildsTextToRange(const QString & tagName, T & destination,
+                                     T minValue, T maxValue);
+    /// @brief Calls copyUniqueChildsTextTo with validator=checkRange0Allowed.
+    template <typename T>
+    void copyUniqueChildsTextToRange0Allowed(
+        const QString & tagName, T & destination, T minValue, T maxValue);
+
+    /// @brief Registers unique child L with name=listTagName. If it is found,
+    /// a list of texts of L's children with name=stringTagName is assigned to
+    /// destination; otherwise destination is not changed.
+    void copyUniqueChildsStringListTo(
+        const QString & listTagName, const QString & stringTagName,
+        QStringList & destination);
+
+    /// @brief Registers unique child with name=tagName. If it is found,
+    /// handler(reader) is called while the child is the current element.
+    /// NOTE: handler is called as soon as the child is encountered, i.e.
+    /// before uniqueness of the child is verified.
+    /// @tparam ChildHandler Must be a callable object that takes a single
+    /// parameter of type (StreamReader &).
+    template <typename ChildHandler>
+    void getUniqueChild(const QString & tagName, ChildHandler handler);
+
+    /// @brief Registers children with name=tagName. handler(reader) is called
+    /// for each of them in the order of appearance while the child is the
+    /// current element.
+    /// @tparam ChildHandler Must be a callable object that takes a single
+    /// parameter of type (StreamReader &).
+    template <typename ChildHandler>
+    void getChildren(const QString & tagName, ChildHandler handler);
+
+    /// @brief Reads all children of reader's current element in a single
+    /// forward pass and moves past its end.
+    /// @throw ReadError If a registered unique child is not unique or a
+    /// conversion/validation fails.
+    void read(StreamReader & reader);
+
+    /// @return true if the last read() has found at least one child with
+    /// name=tagName, which must be registered.
+    bool hasChild(const QString & tagName) const;
+
+private:
+    typedef std::function<void ()> Assignment;
+
+    struct Entry {
+        QString tagName;
+        bool unique;
+        int count;
+        QString text;
+        QStringList strings;
+        /// Reads the child, which is the current element of reader.
+        std::function<void (StreamReader &, Entry &)> readChild;
+        /// Converts and validates the read value after the whole element
+        /// has been read without changing destination. Returns a
+        /// non-throwing function, which assigns the value to destination.
+        std::function<Assignment (const Entry &)> prepare;
+    };
+
+    void addUniqueText(const QString & tagName,
+                       std::function<Assignment (const QString &)> prepare);
+    void add(Entry entry);
+    Entry * find(const StreamReader & reader);
+
+    std::vector<Entry> entries_;
+    /// Maps tag names to indices in entries_.
+    QHash<QString, int> indices_;
+};
+
+} // END namespace XmlReading
+} // END namespace QtUtilities
+
+# include "../../src/StreamReading-inl.hpp"
+
+# endif // QT_XML_UTILITIES_STREAM_READING_HPP
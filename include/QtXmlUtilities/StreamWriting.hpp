@@ -0,0 +1,216 @@
+/*
+ This file is part of vedgTools/QtXmlUtilities.
+ Copyright (C) 2014, 2015 Igor Kushnir <igorkuo AT Google mail>
+
+ vedgTools/QtXmlUtilities is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ vedgTools/QtXmlUtilities is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ vedgTools/QtXmlUtilities.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# ifndef QT_XML_UTILITIES_STREAM_WRITING_HPP
+# define QT_XML_UTILITIES_STREAM_WRITING_HPP
+
+# include <QtXmlUtilities/WritingShortcuts.hpp>
+
+# include <QtCoreUtilities/String.hpp>
+
+# include <QtGlobal>
+# include <QString>
+# include <QXmlStreamWriter>
+
+# include <cstddef>
+# include <memory>
+# include <vector>
+
+
+QT_FORWARD_DECLARE_CLASS(QByteArray)
+QT_FORWARD_DECLARE_CLASS(QStringList)
+QT_FORWARD_DECLARE_CLASS(QIODevice)
+QT_FORWARD_DECLARE_CLASS(QFile)
+# if QT_VERSION >= QT_VERSION_CHECK(5, 1, 0)
+QT_FORWARD_DECLARE_CLASS(QSaveFile)
+# endif
+
+namespace QtUtilities
+{
+namespace XmlWriting
+{
+class StreamDocument;
+
+/// @brief Element of StreamDocument. Has the same interface as Element, but
+/// is written to the output device immediately instead of being stored in
+/// memory.
+/// Start tag of the element is written on construction; end tag is written by
+/// close() or by the destructor. As the output is written sequentially,
+/// appending anything to an element closes all its open descendants.
+/// Nothing may be appended to a closed element.
+class StreamElement
+{
+public:
+    StreamElement(StreamElement && other);
+    StreamElement(const StreamElement &) = delete;
+    StreamElement & operator=(const StreamElement &) = delete;
+    ~StreamElement();
+
+    /// @throw WriteError If this element is closed.
+    StreamElement appendElement(const QString & tagName);
+
+    /// @brief Writes element (name=tagName, text=text).
+    /// @throw WriteError If this element is closed.
+    void appendChild(const QString & tagName, const QString & text);
+    template <typename T>
+    void appendChild(const QString & tagName, const T & value) {
+        appendChild(tagName, toQString(value));
+    }
+
+    void appendChildByteArray(const QString & tagName,
+                              const QByteArray & byteArray) {
+        appendChild(tagName, byteArrayToQString(byteArray));
+    }
+    /// @brief Writes element (name=tagName, text=data encoded in encoding).
+    /// data is encoded in fixed-size pieces straight to the output, so the
+    /// whole encoded text is never held in memory.
+    /// @throw WriteError If this element is closed.
+    void appendChildBinary(const QString & tagName, const QByteArray & data,
+                           BinaryEncoding encoding = BinaryEncoding::Base64);
+
+    template <typename ValueType, typename AttributeType>
+    void appendChildWithAttribute(const QString & tagName,
+                                  const ValueType & value,
+                                  const QString & attributeName,
+                                  const AttributeType & attributeValue) {
+        appendChildWithAttributeText(tagName, detail::toText(value),
+                                     attributeName,
+                                     detail::toText(attributeValue));
+    }
+
+    void appendChildStringList(const QString & listTagName,
+                               const QString & stringTagName,
+                               const QStringList & list);
+
+    /// @brief Writes element (name=tagName, text=value) for each value in
+    /// range; see Element::appendChildren(). Integers are formatted into a
+    /// single reused buffer.
+    /// @throw WriteError If this element is closed.
+    template <class Range>
+    void appendChildren(const QString & tagName, const Range & range) {
+        QXmlStreamWriter & writer = prepareForAppending();
+        QString text;
+        for (const auto & value : range) {
+            detail::assignText(text, value);
+            writer.writeTextElement(tagName, text);
+        }
+    }
+    /// @brief Writes element with name=tagName for each value in range and
+    /// calls fill(child, value), where child is StreamElement, to write the
+    /// value.
+    /// @throw WriteError If this element is closed.
+    template <class Range, typename ValueToElement>
+    void appendChildren(const QString & tagName, const Range & range,
+                        ValueToElement fill) {
+        for (const auto & value : range) {
+            StreamElement child = appendElement(tagName);
+            fill(child, value);
+        }
+    }
+
+    /// @brief Writes end tags of this element and of all its open
+    /// descendants. Does nothing if this element is already closed.
+    void close();
+
+private:
+    explicit StreamElement(StreamDocument & document);
+
+    /// @brief Closes open descendants of this element.
+    /// @throw WriteError If this element is closed.
+    QXmlStreamWriter & prepareForAppending();
+
+    void appendChildWithAttributeText(
+        const QString & tagName, const QString & text,
+        const QString & attributeName, const QString & attributeText);
+
+    /// Is nullptr if this element was moved from.
+    StreamDocument * document_;
+    unsigned id_;
+    std::size_t depth_;
+
+    friend class StreamDocument;
+};
+
+/// @brief Has the same purpose as Document, but writes XML to a QIODevice
+/// while it is being constructed, so the memory usage does not depend on the
+/// size of the document.
+class StreamDocument
+{
+public:
+    /// @brief Writes document to device, which must be open for writing and
+    /// must outlive this document.
+    /// @param indent Amount of space to indent subelements. If negative,
+    /// no whitespace is added.
+    StreamDocument(QIODevice & device, const QString & rootTagName,
+                   int indent = 4);
+    /// @brief Writes document to file, specified by filename. The document
+    /// is written to a temporary file (using QSaveFile, Qt 5.1 or later),
+    /// which replaces the target file only in finish().
+    /// NOTE: QSaveFile is not available before Qt 5.1; there the file is
+    /// truncated and written in place.
+    /// @throw WriteError If the file could not be opened.
+    StreamDocument(const QString & filename, const QString & rootTagName,
+                   int indent = 4);
+
+    StreamDocument(const StreamDocument &) = delete;
+    StreamDocument & operator=(const StreamDocument &) = delete;
+
+    /// @brief If finish() was not called (e.g. because an exception was
+    /// thrown while writing), abandons the document: nothing more is
+    /// written, so the output is not a complete XML document. A target file
+    /// is left unchanged (before Qt 5.1 the incomplete file is removed).
+    ~StreamDocument();
+
+    StreamElement & root() { return *root_; }
+
+    /// @brief Closes all elements, ends the document, flushes the output and
+    /// closes the file (replacing the target file with it). Does nothing if
+    /// called again. No more elements may be appended after calling this
+    /// function.
+    /// @throw WriteError In case of writing error. A target file is left
+    /// unchanged in this case (Qt 5.1 or later).
+    void finish();
+
+private:
+# if QT_VERSION >= QT_VERSION_CHECK(5, 1, 0)
+    typedef QSaveFile File;
+# else
+    typedef QFile File;
+# endif
+
+    void initialize(QIODevice & device, const QString & rootTagName,
+                    int indent);
+    /// @return false in case of error.
+    bool closeFile(bool discard);
+
+    std::unique_ptr<File> file_;
+    QString filename_;
+    QXmlStreamWriter writer_;
+    /// IDs of open elements, from root to the innermost one.
+    std::vector<unsigned> openElements_;
+    unsigned lastId_;
+    bool finished_;
+    std::unique_ptr<StreamElement> root_;
+
+    friend class StreamElement;
+};
+
+} // END namespace XmlWriting
+} // END namespace QtUtilities
+
+# endif // QT_XML_UTILITIES_STREAM_WRITING_HPP
@@ -0,0 +1,195 @@
+/*
+ This file is part of vedgTools/QtXmlUtilities.
+ Copyright (C) 2014, 2015 Igor Kushnir <igorkuo AT Google mail>
+
+ vedgTools/QtXmlUtilities is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ vedgTools/QtXmlUtilities is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ vedgTools/QtXmlUtilities.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# ifndef QT_XML_UTILITIES_STRUCT_BINDING_HPP
+# define QT_XML_UTILITIES_STRUCT_BINDING_HPP
+
+# include <QtXmlUtilities/ReadingShortcuts.hpp>
+# include <QtXmlUtilities/StreamReading.hpp>
+# include <QtXmlUtilities/WritingShortcuts.hpp>
+# include <QtXmlUtilities/StreamWriting.hpp>
+
+# include <QString>
+# include <QHash>
+# include <QDomElement>
+
+# include <cstddef>
+# include <tuple>
+# include <array>
+
+
+namespace QtUtilities
+{
+/// @brief Provides declarative reading and writing of structures.
+namespace XmlBinding
+{
+namespace detail
+{
+/// @brief Validators, which are used by fieldMin() and the like. Named types
+/// (rather than std::bind results) keep field types spellable.
+struct NoValidation {
+    template <typename T>
+    void operator()(const T &) const {}
+};
+
+template <typename T>
+struct MinValidator {
+    void operator()(const T & value) const;
+    T minValue;
+};
+
+template <typename T>
+struct MaxValidator {
+    void operator()(const T & value) const;
+    T maxValue;
+};
+
+template <typename T>
+struct RangeValidator {
+    void operator()(const T & value) const;
+    T minValue, maxValue;
+};
+
+template <typename T>
+struct Range0AllowedValidator {
+    void operator()(const T & value) const;
+    T minValue, maxValue;
+};
+
+} // END namespace detail
+
+
+/// @brief Compile-time descriptor of a struct member bound to a unique child
+/// element, whose text is the member's value. Created by field() and the
+/// like; the member type and the validator are template parameters, so
+/// reading and writing a field involve no type erasure.
+/// @tparam T QString or a default-constructible type with
+/// ConvertQString::to<T> specialization and toQString(T) overload.
+template <class Struct, typename T, typename Validator>
+struct Field {
+    typedef Struct StructType;
+    typedef T ValueType;
+
+    QString tagName;
+    T Struct::* member;
+    Validator validator;
+};
+
+/// @brief Binds member to the unique child with name=tagName.
+template <class Struct, typename T>
+Field<Struct, T, detail::NoValidation> field(const QString & tagName,
+                                              T Struct::* member);
+/// @brief Same as above, but calls validator(value) after reading value.
+/// @throw ReadError (from read()) If calling validator throws Error.
+template <class Struct, typename T, typename Validator>
+Field<Struct, T, Validator> field(const QString & tagName,
+                                  T Struct::* member, Validator validator);
+
+/// @brief Calls field with validator=checkMinValue.
+template <class Struct, typename T>
+Field<Struct, T, detail::MinValidator<T>> fieldMin(
+    const QString & tagName, T Struct::* member, T minValue);
+/// @brief Calls field with validator=checkMaxValue.
+template <class Struct, typename T>
+Field<Struct, T, detail::MaxValidator<T>> fieldMax(
+    const QString & tagName, T Struct::* member, T maxValue);
+/// @brief Calls field with validator=checkRange.
+template <class Struct, typename T>
+Field<Struct, T, detail::RangeValidator<T>> fieldRange(
+    const QString & tagName, T Struct::* member, T minValue, T maxValue);
+/// @brief Calls field with validator=checkRange0Allowed.
+template <class Struct, typename T>
+Field<Struct, T, detail::Range0AllowedValidator<T>> fieldRange0Allowed(
+    const QString & tagName, T Struct::* member, T minValue, T maxValue);
+
+
+/// @brief Describes how members of Struct map to children of an element.
+/// A binding is built once from Field descriptors and then used both for
+/// reading and for writing, so that readers and writers can not drift apart:
+/// @code
+/// static const auto binding = makeStructBinding(
+///     field("name", & Settings::name),
+///     fieldRange("count", & Settings::count, 1, 100));
+/// binding.read(element, settings);
+/// binding.write(parentElement.appendElement("settings"), settings);
+/// @endcode
+/// Reading makes a single pass over the children of the element and
+/// dispatches each child to its field by tag name. Uniqueness checks,
+/// conversions and ReadError messages are the same as in
+/// XmlReading::copyUniqueChildsTextTo. Fields, whose children are absent,
+/// are not changed. All found children are converted and validated before
+/// any field is assigned, so destination is not changed if read() throws.
+/// This matches XmlReading::ChildrenReader.
+template <class Struct, class... Fields>
+class StructBinding
+{
+public:
+    /// @throw Error If two fields have the same tag name.
+    explicit StructBinding(Fields... fields);
+
+    /// @brief Reads bound fields of destination from children of e.
+    /// @throw XmlReading::ReadError In case of parsing error.
+    void read(const QDomElement & e, Struct & destination) const;
+    /// @brief Reads bound fields of destination from children of reader's
+    /// current element and moves past its end.
+    /// @throw XmlReading::ReadError In case of parsing error.
+    void read(XmlReading::StreamReader & reader, Struct & destination) const;
+
+    /// @brief Appends a child to e for each bound field of source.
+    void write(XmlWriting::Element & e, const Struct & source) const;
+    void write(XmlWriting::Element && e, const Struct & source) const {
+        write(e, source);
+    }
+    void write(XmlWriting::StreamElement & e, const Struct & source) const;
+    void write(XmlWriting::StreamElement && e, const Struct & source) const {
+        write(e, source);
+    }
+
+private:
+    typedef std::array<QString, sizeof...(Fields)> Texts;
+    typedef std::array<bool, sizeof...(Fields)> Found;
+
+    /// @brief Converts and validates found texts, then assigns them to the
+    /// corresponding members of destination.
+    /// @throw XmlReading::ReadError If a conversion or validation fails.
+    /// destination is not changed in this case.
+    void assign(const Texts & texts, const Found & found,
+                Struct & destination) const;
+
+    /// @return Index of the field with name=tagName or -1.
+    int indexOf(const QString & tagName) const {
+        return indices_.value(tagName, -1);
+    }
+
+    std::tuple<Fields...> fields_;
+    QHash<QString, int> indices_;
+};
+
+/// @return StructBinding for the struct, whose members are described by
+/// fields.
+/// @throw Error If two fields have the same tag name.
+template <class Field0, class... Fields>
+StructBinding<typename Field0::StructType, Field0, Fields...>
+makeStructBinding(Field0 field0, Fields... fields);
+
+} // END namespace XmlBinding
+} // END namespace QtUtilities
+
+# include "../../src/StructBinding-inl.hpp"
+
+# endif // QT_XML_UTILITIES_STRUCT_BINDING_HPP
@@ -0,0 +1,136 @@
+/*
+ This file is part of vedgTools/QtXmlUtilities.
+ Copyright (C) 2014, 2015 Igor Kushnir <igorkuo AT Google mail>
+
+ vedgTools/QtXmlUtilities is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ vedgTools/QtXmlUtilities is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ vedgTools/QtXmlUtilities.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# ifndef QT_XML_UTILITIES_WATCHED_DOCUMENT_HPP
+# define QT_XML_UTILITIES_WATCHED_DOCUMENT_HPP
+
+# include <QtXmlUtilities/ReadingShortcuts.hpp>
+
+# include <QtGlobal>
+# include <QString>
+# include <QByteArray>
+# include <QMutex>
+# include <QDomElement>
+
+# include <memory>
+# include <atomic>
+# include <functional>
+
+
+QT_FORWARD_DECLARE_CLASS(QFileSystemWatcher)
+QT_FORWARD_DECLARE_CLASS(QTimer)
+
+namespace QtUtilities
+{
+namespace XmlReading
+{
+/// @brief Holds the root element of an XML file and reloads it when the file
+/// changes. Checking an unchanged file costs a single stat call: the file is
+/// read and hashed only if its size or modification time has changed, and
+/// parsed only if its content hash has changed as well.
+/// The new root is published under a mutex, so root() returns either the
+/// old or the new root, never a partially loaded one. root() and
+/// generation() may be called from any thread; reloadIfChanged(), watch()
+/// and stopWatching() must be called from the same single thread.
+/// NOTE: QDomElement handles are not thread-safe. A root returned by root()
+/// must be used by one thread at a time; see CompactDocument for an
+/// alternative that can be shared by concurrent readers.
+class WatchedDocument
+{
+public:
+    typedef std::function<void (const QDomElement & root)> ChangeHandler;
+    typedef std::function<void (const ReadError & error)> ErrorHandler;
+
+    /// @brief Loads the file specified by filename. gzip-compressed files are
+    /// decompressed, as in loadRoot(filename).
+    /// @param rootTagName If not empty, the name of the root element is
+    /// checked with assertTagName() on each load.
+    /// @throw ReadError If the file could not be loaded.
+    explicit WatchedDocument(const QString & filename,
+                             const QString & rootTagName = QString());
+    ~WatchedDocument();
+
+    WatchedDocument(const WatchedDocument &) = delete;
+    WatchedDocument & operator=(const WatchedDocument &) = delete;
+
+    const QString & filename() const { return filename_; }
+
+    /// @return Root element of the last successfully loaded document.
+    QDomElement root() const;
+    /// @return Number of times the document has been (re)loaded. Can be
+    /// compared with a previously returned value to detect a reload.
+    quint64 generation() const { return generation_; }
+
+    /// @brief Reloads the document if the file has changed.
+    /// @return true if a new root was published.
+    /// @throw ReadError If the changed file could not be loaded. The previous
+    /// root is kept in this case.
+    bool reloadIfChanged();
+
+# if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
+    /// @brief Watches the file with QFileSystemWatcher and calls
+    /// reloadIfChanged() once change notifications have stopped arriving for
+    /// debounceMs milliseconds. Must be called from a thread with a running
+    /// event loop, which also runs the handlers. Handlers may be empty.
+    /// @param onChange Is called with the new root after each reload.
+    /// @param onError Is called if the changed file could not be loaded.
+    void watch(int debounceMs = 200, ChangeHandler onChange = ChangeHandler(),
+               ErrorHandler onError = ErrorHandler());
+    /// @brief Stops watching the file.
+    void stopWatching();
+# endif
+
+private:
+    /// @brief Size and modification time of the loaded file.
+    struct FileStamp {
+        qint64 size;
+        qint64 modified;
+    };
+
+    static FileStamp stamp(const QString & filename);
+    /// @brief Reads the file, and if its hash differs from hash_, parses it
+    /// and publishes the new root.
+    /// @return true if a new root was published.
+    bool load(const FileStamp & fileStamp);
+# if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
+    /// @brief Adds the file to the watcher unless it is already watched or
+    /// does not exist at the moment.
+    void rewatch();
+# endif
+    void reloadFromWatcher();
+
+    const QString filename_;
+    const QString rootTagName_;
+
+    mutable QMutex mutex_;
+    QDomElement root_;
+    std::atomic<quint64> generation_;
+
+    FileStamp stamp_;
+    QByteArray hash_;
+
+    std::unique_ptr<QFileSystemWatcher> watcher_;
+    std::unique_ptr<QTimer> debounceTimer_;
+    ChangeHandler onChange_;
+    ErrorHandler onError_;
+};
+
+} // END namespace XmlReading
+} // END namespace QtUtilities
+
+# endif // QT_XML_UTILITIES_WATCHED_DOCUMENT_HPP
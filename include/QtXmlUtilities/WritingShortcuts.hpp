@@ -19,26 +19,94 @@
 # ifndef QT_XML_UTILITIES_WRITING_SHORTCUTS_HPP
 # define QT_XML_UTILITIES_WRITING_SHORTCUTS_HPP
 
+# include <QtXmlUtilities/Binary.hpp>
+
 # include <QtCoreUtilities/Error.hpp>
 # include <QtCoreUtilities/String.hpp>
 
 # include <CommonUtilities/CopyAndMoveSemantics.hpp>
 
 # include <QtGlobal>
+# include <QString>
+# include <QChar>
 # include <QDomNode>
 # include <QDomElement>
 # include <QDomDocument>
 
+# include <limits>
+# include <algorithm>
+# include <type_traits>
+
 
 QT_FORWARD_DECLARE_CLASS(QByteArray)
-QT_FORWARD_DECLARE_CLASS(QString)
 QT_FORWARD_DECLARE_CLASS(QStringList)
 
 namespace QtUtilities
 {
 /// @brief Provides shortcuts for constructing QDomDocument.
+/// NOTE: QDomDocument stores tag and attribute names as QString. Names that
+/// are known at compile time should be passed as QStringLiteral constants
+/// (Qt 5): unlike string literals, they are not converted and allocated anew
+/// on each call.
 namespace XmlWriting
 {
+namespace detail
+{
+inline const QString & toText(const QString & text) { return text; }
+template <typename T>
+inline QString toText(const T & value) { return toQString(value); }
+
+/// @brief Is true for integer types, whose text is a plain decimal number.
+/// bool and character types (including wchar_t, char16_t and char32_t) are
+/// excluded.
+template <typename T>
+struct IsFormattedInPlace : std::integral_constant<bool,
+        std::is_integral<T>::value && ! std::is_same<T, bool>::value &&
+        ! std::is_same<T, wchar_t>::value &&
+        ! std::is_same<T, char16_t>::value &&
+        ! std::is_same<T, char32_t>::value && (sizeof(T) > 1)> {};
+
+/// @brief Stores text representation of value in buffer. Integers are
+/// formatted into a stack array and copied into buffer, so no memory is
+/// allocated if buffer is not shared and its capacity suffices (which is
+/// the case when the same buffer is reused for a sequence of values).
+inline void assignText(QString & buffer, const QString & text)
+{
+    buffer = text;
+}
+
+template <typename T>
+inline typename std::enable_if<IsFormattedInPlace<T>::value>::type
+assignText(QString & buffer, const T value)
+{
+    typedef typename std::make_unsigned<T>::type Unsigned;
+    // All decimal digits and a sign.
+    QChar digits[std::numeric_limits<Unsigned>::digits10 + 2];
+    QChar * const end = digits + sizeof(digits) / sizeof(digits[0]);
+    QChar * begin = end;
+
+    const bool negative = std::is_signed<T>::value && value < T(0);
+    Unsigned magnitude = negative ? Unsigned(Unsigned(0) - Unsigned(value)) :
+                         Unsigned(value);
+    do {
+        *--begin = QLatin1Char(char('0' + magnitude % 10));
+        magnitude /= 10;
+    }
+    while (magnitude != 0);
+    if (negative)
+        *--begin = QLatin1Char('-');
+
+    buffer.resize(int(end - begin));
+    std::copy(begin, end, buffer.data());
+}
+template <typename T>
+inline typename std::enable_if<! IsFormattedInPlace<T>::value>::type
+assignText(QString & buffer, const T & value)
+{
+    buffer = toQString(value);
+}
+} // END namespace detail
+
 class WriteError : public Error
 {
 public:
@@ -66,6 +134,16 @@ inline QDomElement createElementFromByteArray(
 {
     return createElement(doc, tagName, byteArrayToQString(byteArray));
 }
+/// @brief Creates element (name=tagName, text=data encoded in encoding) and
+/// returns it. data is encoded in a single pass into a text of the exact
+/// size (see Binary.hpp). Read it back with
+/// XmlReading::copyUniqueChildsBinaryTo().
+inline QDomElement createElementFromBinary(
+    QDomDocument & doc, const QString & tagName, const QByteArray & data,
+    BinaryEncoding encoding = BinaryEncoding::Base64)
+{
+    return createElement(doc, tagName, encodeBinary(data, encoding));
+}
 
 /// @brief Sets the specified attribute's text to attributeText.
 void setAttribute(QDomElement & element, const QString & attributeName,
@@ -85,10 +163,78 @@ QDomElement createStringListElement(
     const QString & stringTagName, const QStringList & list);
 
 
-/// @brief Writes doc to file, specified by filename.
-/// @param indent Amount of space to indent subelements.
+/// @brief Writes doc to file, specified by filename. The document is
+/// serialized straight into the file through a buffer, so the whole
+/// serialized document is never held in memory.
+/// If filename ends with ".gz", the document is gzip-compressed on the fly
+/// (this applies to all save() and saveData() overloads). Throws WriteError
+/// in this case if the library is built without zlib
+/// (QT_XML_UTILITIES_WITH_ZLIB).
+/// @param indent Amount of space to indent subelements. If indent is -1, no
+/// whitespace at all is added (compact mode).
 /// @throw WriteError In case of saving error.
 void save(const QDomDocument & doc, const QString & filename, int indent = 4);
+/// @brief Writes data (e.g. serialized document) to file, specified by
+/// filename.
+/// @throw WriteError In case of saving error.
+void saveData(const QByteArray & data, const QString & filename);
+
+struct SaveOptions {
+    SaveOptions()
+        : indent(4), bufferSize(defaultBufferSize), skipIfUnchanged(false),
+          atomicReplace(true), syncToDisk(false) {
+    }
+
+    static constexpr int defaultBufferSize = 64 * 1024;
+
+    /// Amount of space to indent subelements; -1 means no whitespace at all.
+    int indent;
+    /// Size of the buffer, through which the document is streamed to the file
+    /// if skipIfUnchanged is false.
+    int bufferSize;
+    /// If true, the file is not written if its content is equal to the
+    /// serialized document. The document has to be serialized into memory
+    /// before writing in this case; otherwise (by default) it is streamed to
+    /// the file.
+    bool skipIfUnchanged;
+    /// If true, the file is written to a temporary file, which then replaces
+    /// the target file atomically (using QSaveFile, Qt 5.1 or later).
+    /// QSaveFile always flushes data to disk before replacing the file.
+    /// NOTE: QSaveFile is not available before Qt 5.1; there this option is
+    /// ignored and the file is overwritten in place (non-atomically),
+    /// honoring syncToDisk.
+    bool atomicReplace;
+    /// If true and atomicReplace is false, the written data is flushed to disk
+    /// (fsync) before returning.
+    bool syncToDisk;
+};
+
+/// @brief Writes doc to file, specified by filename, according to options.
+/// @return true if the file was written; false if writing was skipped
+/// because the file has not changed.
+/// @throw WriteError In case of saving error.
+bool save(const QDomDocument & doc, const QString & filename,
+          const SaveOptions & options);
+/// @brief This is an overloaded function, which also maintains the hash of
+/// the file's content.
+/// @param digest [in, out] On input, the hash of the current content of the
+/// file as returned by the previous call; if it is empty, the file is read
+/// instead when options.skipIfUnchanged is true. After a successful call
+/// digest is set to the hash of the saved content, so that the next call
+/// does not need to read the file.
+bool save(const QDomDocument & doc, const QString & filename,
+          const SaveOptions & options, QByteArray & digest);
+/// @brief Writes data to file, specified by filename, according to options
+/// (options.indent is ignored).
+/// @return true if the file was written; false if writing was skipped
+/// because the file has not changed.
+/// @throw WriteError In case of saving error.
+bool saveData(const QByteArray & data, const QString & filename,
+              const SaveOptions & options);
+/// @brief This is an overloaded function, which also maintains the hash of
+/// the file's content; see save(doc, filename, options, digest).
+bool saveData(const QByteArray & data, const QString & filename,
+              const SaveOptions & options, QByteArray & digest);
 
 
 
@@ -114,6 +260,12 @@ struct Element {
                             domDocument, tagName, byteArray));
     }
 
+    void appendChildBinary(const QString & tagName, const QByteArray & data,
+                           BinaryEncoding encoding = BinaryEncoding::Base64) {
+        appendChildNode(createElementFromBinary(
+                            domDocument, tagName, data, encoding));
+    }
+
     template <typename ValueType, typename AttributeType>
     void appendChildWithAttribute(const QString & tagName,
                                   const ValueType & value,
@@ -131,6 +283,32 @@ struct Element {
                             domDocument, listTagName, stringTagName, list));
     }
 
+    /// @brief Appends element (name=tagName, text=value) for each value in
+    /// range. This is the inverse of XmlReading::getChildren(e, tagName,
+    /// childToResultValue). Empty values do not get a text node.
+    /// @tparam Range Must be usable in a range-based for loop. Its values must
+    /// be QString or have a toQString() overload.
+    template <class Range>
+    void appendChildren(const QString & tagName, const Range & range) {
+        for (const auto & value : range) {
+            QDomElement child = domDocument.createElement(tagName);
+            const QString & text = detail::toText(value);
+            if (! text.isEmpty())
+                child.appendChild(domDocument.createTextNode(text));
+            domElement.appendChild(child);
+        }
+    }
+    /// @brief Appends element with name=tagName for each value in range and
+    /// calls fill(child, value), where child is Element, to write the value.
+    template <class Range, typename ValueToElement>
+    void appendChildren(const QString & tagName, const Range & range,
+                        ValueToElement fill) {
+        for (const auto & value : range) {
+            Element child = appendElement(tagName);
+            fill(child, value);
+        }
+    }
+
     QDomDocument & domDocument;
     QDomElement domElement;
 };
@@ -145,6 +323,14 @@ struct Document {
         XmlWriting::save(domDocument, filename, indent);
     }
 
+    bool save(const QString & filename, const SaveOptions & options) {
+        return XmlWriting::save(domDocument, filename, options);
+    }
+    bool save(const QString & filename, const SaveOptions & options,
+              QByteArray & digest) {
+        return XmlWriting::save(domDocument, filename, options, digest);
+    }
+
     QDomDocument domDocument;
     Element root;
 };
@@ -0,0 +1,120 @@
+/*
+ This file is part of vedgTools/QtXmlUtilities.
+ Copyright (C) 2014, 2015 Igor Kushnir <igorkuo AT Google mail>
+
+ vedgTools/QtXmlUtilities is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ vedgTools/QtXmlUtilities is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ vedgTools/QtXmlUtilities.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# include "AsyncWriting.hpp"
+
+# include "ThreadPool.hpp"
+
+# include <QByteArray>
+# include <QString>
+# include <QThreadPool>
+# include <QDomDocument>
+
+# include <exception>
+# include <memory>
+# include <utility>
+# include <future>
+# include <vector>
+
+
+namespace QtUtilities
+{
+namespace XmlWriting
+{
+namespace
+{
+QThreadPool & threadPool(QThreadPool * const pool)
+{
+    return pool == nullptr ? *QThreadPool::globalInstance() : *pool;
+}
+
+/// @brief Calls function() on a thread of pool.
+/// @return Future, which receives the exception thrown by function() if any.
+template <typename Function>
+std::future<void> startAsync(QThreadPool * const pool, Function function)
+{
+    const auto promise = std::make_shared<std::promise<void>>();
+    std::future<void> future = promise->get_future();
+    Parallel::start(threadPool(pool), [promise, function] {
+        try {
+            function();
+            promise->set_value();
+        }
+        catch (...) {
+            promise->set_exception(std::current_exception());
+        }
+    });
+    return future;
+}
+
+} // END unnamed namespace
+
+
+std::future<void> saveAsync(QDomDocument && doc, const QString & filename,
+                            const int indent, QThreadPool * const pool)
+{
+    // The document is shared via std::shared_ptr so that the non-atomic
+    // reference count of QDomDocument is not touched after this point.
+    const auto owned = std::make_shared<QDomDocument>(doc);
+    doc.clear();
+    return startAsync(pool, [owned, filename, indent] {
+        save(*owned, filename, indent);
+    });
+}
+
+std::future<void> saveAsync(const Document & document,
+                            const QString & filename, const int indent,
+                            QThreadPool * const pool)
+{
+    const QByteArray data = document.domDocument.toByteArray(indent);
+    return startAsync(pool, [data, filename] {
+        saveData(data, filename);
+    });
+}
+
+std::future<void> saveAsync(std::vector<DocumentToSave> && documents,
+                            QThreadPool * const pool)
+{
+    const auto owned =
+        std::make_shared<std::vector<DocumentToSave>>(std::move(documents));
+    QThreadPool & workers = threadPool(pool);
+    return startAsync(pool, [owned, &workers] {
+        const int count = static_cast<int>(owned->size());
+        std::vector<QByteArray> serialized(owned->size());
+        Parallel::forEachIndex(workers, count, [&](const int i) {
+            const DocumentToSave & d = (*owned)[i];
+            serialized[i] = d.document.toByteArray(d.indent);
+        });
+        std::exception_ptr firstError;
+        for (int i = 0; i < count; ++i) {
+            try {
+                saveData(serialized[i], (*owned)[i].filename);
+            }
+            catch (...) {
+                if (! firstError)
+                    firstError = std::current_exception();
+            }
+            serialized[i].clear();
+        }
+        if (firstError)
+            std::rethrow_exception(firstError);
+    });
+}
+
+} // END namespace XmlWriting
+} // END namespace QtUtilities
@@ -0,0 +1,219 @@
+/*
+ This file is part of vedgTools/QtXmlUtilities.
+ Copyright (C) 2014, 2015 Igor Kushnir <igorkuo AT Google mail>
+
+ vedgTools/QtXmlUtilities is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ vedgTools/QtXmlUtilities is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ vedgTools/QtXmlUtilities.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# include "Binary.hpp"
+
+# include <QtGlobal>
+# include <QChar>
+# include <QByteArray>
+# include <QString>
+
+# include <algorithm>
+
+
+namespace QtUtilities
+{
+namespace
+{
+const char base64Alphabet[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+const char hexDigits[] = "0123456789abcdef";
+
+enum : signed char { invalid = -1, whitespace = -2, padding = -3 };
+
+/// @brief Lookup table from Latin-1 character to its value in encoding.
+class DecodingTable
+{
+public:
+    explicit DecodingTable(const BinaryEncoding encoding) {
+        std::fill(values_, values_ + 256, invalid);
+        values_[int(' ')] = values_[int('\t')] = whitespace;
+        values_[int('\r')] = values_[int('\n')] = whitespace;
+        if (encoding == BinaryEncoding::Base64) {
+            for (int i = 0; i < 64; ++i)
+                values_[int(base64Alphabet[i])] = static_cast<signed char>(i);
+            values_[int('=')] = padding;
+        }
+        else {
+            for (int i = 0; i < 16; ++i)
+                values_[int(hexDigits[i])] = static_cast<signed char>(i);
+            for (int i = 10; i < 16; ++i)
+                values_['A' + i - 10] = static_cast<signed char>(i);
+        }
+    }
+
+    int operator()(const QChar c) const {
+        const ushort u = c.unicode();
+        return u < 256 ? values_[u] : invalid;
+    }
+
+private:
+    signed char values_[256];
+};
+
+const DecodingTable & decodingTable(const BinaryEncoding encoding)
+{
+    static const DecodingTable base64(BinaryEncoding::Base64);
+    static const DecodingTable hex(BinaryEncoding::Hex);
+    return encoding == BinaryEncoding::Base64 ? base64 : hex;
+}
+
+} // END unnamed namespace
+
+
+const char * encodingName(const BinaryEncoding encoding)
+{
+    return encoding == BinaryEncoding::Base64 ? "base64" : "hex";
+}
+
+int encodedLength(const int size, const BinaryEncoding encoding)
+{
+    return encoding == BinaryEncoding::Base64 ? (size + 2) / 3 * 4 : size * 2;
+}
+
+void encodeBinary(const char * const data, const int size,
+                  const BinaryEncoding encoding, QChar * destination)
+{
+    const uchar * in = reinterpret_cast<const uchar *>(data);
+    const uchar * const end = in + size;
+    if (encoding == BinaryEncoding::Hex) {
+        for (; in != end; ++in) {
+            *destination++ = QLatin1Char(hexDigits[*in >> 4]);
+            *destination++ = QLatin1Char(hexDigits[*in & 0xF]);
+        }
+        return;
+    }
+    for (; end - in >= 3; in += 3) {
+        const quint32 group = quint32(in[0]) << 16 | quint32(in[1]) << 8 |
+                              in[2];
+        destination[0] = QLatin1Char(base64Alphabet[group >> 18]);
+        destination[1] = QLatin1Char(base64Alphabet[group >> 12 & 0x3F]);
+        destination[2] = QLatin1Char(base64Alphabet[group >> 6 & 0x3F]);
+        destination[3] = QLatin1Char(base64Alphabet[group & 0x3F]);
+        destination += 4;
+    }
+    if (in == end)
+        return;
+    const bool two = end - in == 2;
+    const quint32 group = quint32(in[0]) << 16 |
+                          (two ? quint32(in[1]) << 8 : 0);
+    destination[0] = QLatin1Char(base64Alphabet[group >> 18]);
+    destination[1] = QLatin1Char(base64Alphabet[group >> 12 & 0x3F]);
+    destination[2] = two ? QLatin1Char(base64Alphabet[group >> 6 & 0x3F]) :
+                     QLatin1Char('=');
+    destination[3] = QLatin1Char('=');
+}
+
+QString encodeBinary(const QByteArray & data, const BinaryEncoding encoding)
+{
+    QString text(encodedLength(data.size(), encoding), Qt::Uninitialized);
+    encodeBinary(data.constData(), data.size(), encoding, text.data());
+    return text;
+}
+
+
+bool BinaryDecoder::add(const QChar * text, const int length)
+{
+    reserve(encoding_ == BinaryEncoding::Base64 ? length / 4 * 3 + 3 :
+            length / 2 + 1);
+    const DecodingTable & table = decodingTable(encoding_);
+    char * out = result_.data() + size_;
+    const int bitsPerChar = encoding_ == BinaryEncoding::Base64 ? 6 : 4;
+    const int groupLength = encoding_ == BinaryEncoding::Base64 ? 4 : 2;
+    for (const QChar * const end = text + length; text != end; ++text) {
+        const int value = table(*text);
+        if (value >= 0) {
+            if (padding_ != 0)
+                return false; // Data after padding.
+            bits_ = bits_ << bitsPerChar | quint32(value);
+            if (++pending_ == groupLength) {
+                if (groupLength == 4) {
+                    *out++ = char(bits_ >> 16);
+                    *out++ = char(bits_ >> 8);
+                }
+                *out++ = char(bits_);
+                bits_ = 0;
+                pending_ = 0;
+            }
+        }
+        else if (value == padding) {
+            if (++padding_ > 2)
+                return false;
+        }
+        else if (value != whitespace)
+            return false;
+    }
+    size_ = int(out - result_.constData());
+    return true;
+}
+
+bool BinaryDecoder::finish()
+{
+    if (encoding_ == BinaryEncoding::Hex)
+        return pending_ == 0;
+    if (padding_ != 0 && pending_ + padding_ != 4)
+        return false;
+    // Unpadded input is accepted too.
+    switch (pending_) {
+        case 0:
+            return padding_ == 0;
+        case 2:
+            reserve(1);
+            result_[size_++] = char(bits_ >> 4);
+            break;
+        case 3:
+            reserve(2);
+            result_[size_++] = char(bits_ >> 10);
+            result_[size_++] = char(bits_ >> 2);
+            break;
+        default:
+            return false;
+    }
+    bits_ = 0;
+    pending_ = 0;
+    return true;
+}
+
+QByteArray BinaryDecoder::takeResult()
+{
+    result_.resize(size_);
+    QByteArray result;
+    result.swap(result_);
+    size_ = 0;
+    return result;
+}
+
+void BinaryDecoder::reserve(const int maxBytes)
+{
+    const int required = size_ + maxBytes;
+    if (result_.size() < required)
+        result_.resize(std::max(required, result_.size() * 2));
+}
+
+
+bool decodeBinary(const QString & text, const BinaryEncoding encoding,
+                  QByteArray & destination)
+{
+    BinaryDecoder decoder(encoding);
+    if (! decoder.add(text) || ! decoder.finish())
+        return false;
+    destination = decoder.takeResult();
+    return true;
+}
+
+} // END namespace QtUtilities
@@ -0,0 +1,60 @@
+/*
+ This file is part of vedgTools/QtXmlUtilities.
+ Copyright (C) 2014, 2015 Igor Kushnir <igorkuo AT Google mail>
+
+ vedgTools/QtXmlUtilities is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ vedgTools/QtXmlUtilities is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ vedgTools/QtXmlUtilities.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# ifndef QT_XML_UTILITIES_COMPACT_DOCUMENT_INL_HPP
+# define QT_XML_UTILITIES_COMPACT_DOCUMENT_INL_HPP
+
+# include <QtXmlUtilities/CompactDocument.hpp>
+
+# include <QString>
+
+
+namespace QtUtilities
+{
+namespace XmlReading
+{
+template <class CompactElementCollection>
+CompactElementCollection getChildren(const CompactElement & e,
+                                     const QString & tagName)
+{
+    detail::LookupScan scan;
+    CompactElementCollection children;
+    for (CompactElement child = scan.first(e, tagName); ! child.isNull();
+            child = scan.next(child, tagName)) {
+        children.push_back(child);
+    }
+    return children;
+}
+
+template <class TCollection, typename ElementToT>
+TCollection getChildren(const CompactElement & e, const QString & tagName,
+                        ElementToT childToResultValue)
+{
+    detail::LookupScan scan;
+    TCollection converted;
+    for (CompactElement child = scan.first(e, tagName); ! child.isNull();
+            child = scan.next(child, tagName)) {
+        converted.push_back(childToResultValue(child));
+    }
+    return converted;
+}
+
+} // END namespace XmlReading
+} // END namespace QtUtilities
+
+# endif // QT_XML_UTILITIES_COMPACT_DOCUMENT_INL_HPP
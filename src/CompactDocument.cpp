@@ -0,0 +1,445 @@
+/*
+ This file is part of vedgTools/QtXmlUtilities.
+ Copyright (C) 2014, 2015 Igor Kushnir <igorkuo AT Google mail>
+
+ vedgTools/QtXmlUtilities is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ vedgTools/QtXmlUtilities is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ vedgTools/QtXmlUtilities.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# include "CompactDocument.hpp"
+
+# include <QtCoreUtilities/String.hpp>
+
+# include <QByteArray>
+# include <QString>
+# include <QLatin1String>
+# include <QStringList>
+# include <QObject>
+# include <QIODevice>
+# include <QFile>
+# include <QXmlStreamReader>
+# include <QXmlStreamAttributes>
+# include <QDomNode>
+# include <QDomElement>
+# include <QDomNamedNodeMap>
+# include <QDomAttr>
+
+# include <cstddef>
+# include <limits>
+# include <memory>
+# include <utility>
+# include <vector>
+
+
+namespace QtUtilities
+{
+namespace XmlReading
+{
+namespace
+{
+QString fileSourceName(const QString & filename)
+{
+    return QObject::tr("file %1").arg(filename);
+}
+
+/// @throw ReadError If size does not fit in qint32.
+qint32 toIndex(const std::size_t size)
+{
+    if (size > std::size_t(std::numeric_limits<qint32>::max()))
+        throw ReadError(QObject::tr("XML document is too large."));
+    return qint32(size);
+}
+
+qint32 intern(detail::CompactData & data, const QString & name)
+{
+    const auto it = data.nameIndices.constFind(name);
+    if (it != data.nameIndices.constEnd())
+        return it.value();
+    const qint32 index = toIndex(data.names.size());
+    data.names.push_back(name);
+    data.nameIndices.insert(name, index);
+    return index;
+}
+
+qint32 intern(detail::CompactData & data, const QStringRef & name)
+{
+    return intern(data, name.toString());
+}
+
+/// @brief Appends element with name=nameIndex to data. Its attributes must
+/// be the last attributeCount attributes appended to data.
+/// @return Index of the new node.
+qint32 appendNode(detail::CompactData & data, const qint32 nameIndex,
+                  const qint32 attributeCount)
+{
+    detail::CompactNode node;
+    node.name = nameIndex;
+    node.firstChild = node.nextSibling = -1;
+    node.firstAttribute = toIndex(data.attributes.size()) - attributeCount;
+    node.attributeCount = attributeCount;
+    node.textBegin = node.textEnd = data.texts.size();
+    const qint32 index = toIndex(data.nodes.size());
+    data.nodes.push_back(node);
+    return index;
+}
+
+/// @tparam TString QString or QStringRef.
+template <class TString>
+void appendAttribute(detail::CompactData & data, const TString & name,
+                     const TString & value)
+{
+    detail::CompactAttribute attribute;
+    attribute.name = intern(data, name);
+    attribute.valueBegin = data.values.size();
+    data.values += value;
+    attribute.valueEnd = toIndex(std::size_t(data.values.size()));
+    data.attributes.push_back(attribute);
+}
+
+/// @brief Makes child the next child of parent, whose last child so far is
+/// lastChild (-1 if there were no children), and sets lastChild to child.
+void link(detail::CompactData & data, const qint32 parent, qint32 & lastChild,
+          const qint32 child)
+{
+    detail::CompactNode & previous =
+        data.nodes[std::size_t(lastChild == -1 ? parent : lastChild)];
+    (lastChild == -1 ? previous.firstChild : previous.nextSibling) = child;
+    lastChild = child;
+}
+
+/// @brief Appends the current element of xml and its attributes to data.
+/// @return Index of the new node.
+qint32 appendElement(QXmlStreamReader & xml, detail::CompactData & data)
+{
+    const qint32 name = intern(data, xml.qualifiedName());
+    const QXmlStreamAttributes attributes = xml.attributes();
+    for (const QXmlStreamAttribute & a : attributes)
+        appendAttribute(data, a.qualifiedName(), a.value());
+    return appendNode(data, name, attributes.size());
+}
+
+/// @brief Appends e and its attributes to data.
+/// @return Index of the new node.
+qint32 appendElement(const QDomElement & e, detail::CompactData & data)
+{
+    const qint32 name = intern(data, e.tagName());
+    const QDomNamedNodeMap attributes = e.attributes();
+    const int attributeCount = attributes.count();
+    for (int i = 0; i < attributeCount; ++i) {
+        const QDomAttr a = attributes.item(i).toAttr();
+        appendAttribute(data, a.name(), a.value());
+    }
+    return appendNode(data, name, attributeCount);
+}
+
+/// @brief Appends root and all its descendants to data in document order.
+/// Uses an explicit stack like build() so that deeply nested trees can not
+/// overflow the call stack.
+void freezeTree(const QDomElement & root, detail::CompactData & data)
+{
+    struct Open {
+        qint32 node;
+        qint32 lastChild;
+        QDomNode nextChild;
+    };
+    std::vector<Open> open;
+    open.push_back(Open { appendElement(root, data), -1, root.firstChild() });
+
+    while (! open.empty()) {
+        Open & top = open.back();
+        if (top.nextChild.isNull()) {
+            data.nodes[std::size_t(top.node)].textEnd = data.texts.size();
+            open.pop_back();
+            continue;
+        }
+        const QDomNode child = top.nextChild;
+        top.nextChild = child.nextSibling();
+        if (child.isElement()) {
+            const qint32 index = appendElement(child.toElement(), data);
+            link(data, top.node, top.lastChild, index);
+            // top may be invalidated here; it is not used afterwards.
+            open.push_back(Open { index, -1, child.firstChild() });
+        }
+        else if (child.isText()) // CDATA sections are texts as well.
+            data.texts += child.nodeValue();
+    }
+}
+
+void squeeze(detail::CompactData & data)
+{
+    data.nodes.shrink_to_fit();
+    data.attributes.shrink_to_fit();
+    data.texts.squeeze();
+    data.values.squeeze();
+}
+
+/// @param sourceName Description of source for error message.
+std::shared_ptr<const detail::CompactData> build(
+    QXmlStreamReader & xml, const QString & sourceName)
+{
+    // Element names are compared as written, the same way QDomDocument does
+    // when namespace processing is disabled.
+    xml.setNamespaceProcessing(false);
+
+    auto data = std::make_shared<detail::CompactData>();
+    struct Open {
+        qint32 node;
+        qint32 lastChild;
+    };
+    std::vector<Open> open;
+
+    while (! xml.atEnd()) {
+        switch (xml.readNext()) {
+            case QXmlStreamReader::StartElement: {
+                const qint32 index = appendElement(xml, *data);
+                if (! open.empty())
+                    link(*data, open.back().node, open.back().lastChild, index);
+                open.push_back(Open { index, -1 });
+                break;
+            }
+            case QXmlStreamReader::EndElement:
+                data->nodes[std::size_t(open.back().node)].textEnd =
+                    data->texts.size();
+                open.pop_back();
+                break;
+            case QXmlStreamReader::Characters:
+                // QDomDocument drops whitespace-only text nodes too.
+                if (! open.empty() && (xml.isCDATA() || ! xml.isWhitespace()))
+                    data->texts += xml.text();
+                break;
+            default:
+                break;
+        }
+    }
+
+    if (xml.hasError()) {
+        throw ReadError(
+            QObject::tr("could not load XML document from %1."
+                        " On line %2 at column %3: %4.").arg(sourceName).arg(
+                xml.lineNumber()).arg(xml.columnNumber()).arg(
+                xml.errorString()));
+    }
+    squeeze(*data);
+    return data;
+}
+
+} // END unnamed namespace
+
+
+QString CompactElement::attribute(const QString & name,
+                                  const QString & defaultValue) const
+{
+    const detail::CompactAttribute * const a = findAttribute(name);
+    if (a == nullptr)
+        return defaultValue;
+    return data_->values.mid(a->valueBegin, a->valueEnd - a->valueBegin);
+}
+
+CompactElement CompactElement::firstChildElement(const QString & tagName) const
+{
+    if (isNull())
+        return CompactElement();
+    if (tagName.isEmpty())
+        return CompactElement(data_, node().firstChild);
+    return findFrom(node().firstChild, data_->nameIndex(tagName));
+}
+
+CompactElement CompactElement::firstChildElement(QLatin1String tagName) const
+{
+    if (isNull())
+        return CompactElement();
+    return findFrom(node().firstChild, tagName);
+}
+
+CompactElement CompactElement::nextSiblingElement(
+    const QString & tagName) const
+{
+    if (isNull())
+        return CompactElement();
+    if (tagName.isEmpty())
+        return CompactElement(data_, node().nextSibling);
+    return findFrom(node().nextSibling, data_->nameIndex(tagName));
+}
+
+CompactElement CompactElement::nextSiblingElement(QLatin1String tagName) const
+{
+    if (isNull())
+        return CompactElement();
+    return findFrom(node().nextSibling, tagName);
+}
+
+const detail::CompactAttribute * CompactElement::findAttribute(
+    const QString & name) const
+{
+    if (isNull())
+        return nullptr;
+    const qint32 nameIndex = data_->nameIndex(name);
+    if (nameIndex == -1)
+        return nullptr;
+    const detail::CompactNode & n = node();
+    // firstAttribute may be equal to the size of attributes (possibly 0) if
+    // there are no attributes, so it must not be dereferenced in this case.
+    if (n.attributeCount == 0)
+        return nullptr;
+    const detail::CompactAttribute * a =
+        data_->attributes.data() + n.firstAttribute;
+    for (const auto * const end = a + n.attributeCount; a != end; ++a) {
+        if (a->name == nameIndex)
+            return a;
+    }
+    return nullptr;
+}
+
+CompactElement CompactElement::findFrom(qint32 index,
+                                        const qint32 nameIndex) const
+{
+    if (nameIndex == -1)
+        return CompactElement();
+    while (index != -1 && data_->nodes[std::size_t(index)].name != nameIndex)
+        index = data_->nodes[std::size_t(index)].nextSibling;
+    return CompactElement(data_, index);
+}
+
+CompactElement CompactElement::findFrom(qint32 index,
+                                        const QLatin1String tagName) const
+{
+    while (index != -1) {
+        const detail::CompactNode & n = data_->nodes[std::size_t(index)];
+        if (data_->names[std::size_t(n.name)] == tagName)
+            break;
+        index = n.nextSibling;
+    }
+    return CompactElement(data_, index);
+}
+
+
+CompactDocument loadCompactDocument(const QString & filename)
+{
+    QFile file(filename);
+    if (! file.open(QIODevice::ReadOnly)) {
+        throw ReadError(
+            QObject::tr("could not open file %1 for reading.").arg(filename));
+    }
+    QXmlStreamReader xml(& file);
+    return CompactDocument(build(xml, fileSourceName(filename)));
+}
+
+CompactDocument loadCompactDocument(QIODevice & device)
+{
+    if (! device.isOpen() && ! device.open(QIODevice::ReadOnly)) {
+        throw ReadError(
+            QObject::tr("could not open device for reading."));
+    }
+    QXmlStreamReader xml(& device);
+    return CompactDocument(build(xml, QObject::tr("device")));
+}
+
+CompactDocument loadCompactDocumentFromData(const QByteArray & data)
+{
+    QXmlStreamReader xml(data);
+    return CompactDocument(build(xml, QObject::tr("data")));
+}
+
+CompactDocument freeze(const QDomElement & root)
+{
+    if (root.isNull())
+        return CompactDocument();
+    auto data = std::make_shared<detail::CompactData>();
+    freezeTree(root, *data);
+    squeeze(*data);
+    return CompactDocument(std::move(data));
+}
+
+
+void assertTagName(const CompactElement & e, const QString & tagName)
+{
+    if (e.tagName() != tagName) {
+        throw ReadError(
+            QObject::tr(
+                "tag name assertion failed. \"%1\" expected "
+                "but \"%2\" found.").arg(tagName, e.tagName()));
+    }
+}
+
+CompactElement getUniqueChild(const CompactElement & e,
+                              const QString & tagName)
+{
+    detail::LookupScan scan;
+    const CompactElement child = scan.first(e, tagName);
+    if (! scan.next(child, tagName).isNull())
+        detail::throwNotUniqueError(tagName);
+    return child;
+}
+
+bool copyElementsAttributeTo(
+    const CompactElement & e, const QString & attributeName,
+    QString & destination)
+{
+    if (! e.hasAttribute(attributeName))
+        return false;
+    destination = e.attribute(attributeName);
+    return true;
+}
+
+bool copyUniqueChildsTextTo(const CompactElement & e, const QString & tagName,
+                            QString & destination)
+{
+    const CompactElement child = getUniqueChild(e, tagName);
+    if (child.isNull())
+        return false;
+    destination = child.text();
+    return true;
+}
+
+bool copyUniqueChildsTextToByteArray(
+    const CompactElement & e, const QString & tagName,
+    QByteArray & destination)
+{
+    QString text;
+    if (copyUniqueChildsTextTo(e, tagName, text)) {
+        destination = qStringToByteArray(text);
+        return true;
+    }
+    return false;
+}
+
+ReadStatus tryCopyUniqueChildsTextTo(
+    const CompactElement & e, const QString & tagName,
+    QString & destination) noexcept
+{
+    detail::LookupScan scan;
+    const CompactElement child = scan.first(e, tagName);
+    if (child.isNull())
+        return ReadStatus(ReadStatus::Absent, tagName, false);
+    if (! scan.next(child, tagName).isNull())
+        return ReadStatus(ReadStatus::NotUnique, tagName, false);
+    destination = child.text();
+    return ReadStatus();
+}
+
+bool copyUniqueChildsStringListTo(
+    const CompactElement & e, const QString & listTagName,
+    const QString & stringTagName, QStringList & destination)
+{
+    const CompactElement listElement = getUniqueChild(e, listTagName);
+    if (listElement.isNull())
+        return false;
+    destination = getChildren<QStringList>(listElement, stringTagName,
+    [](const CompactElement & ce) {
+        return ce.text();
+    });
+    return true;
+}
+
+} // END namespace XmlReading
+} // END namespace QtUtilities
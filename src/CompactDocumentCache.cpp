@@ -0,0 +1,314 @@
+/*
+ This file is part of vedgTools/QtXmlUtilities.
+ Copyright (C) 2014, 2015 Igor Kushnir <igorkuo AT Google mail>
+
+ vedgTools/QtXmlUtilities is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ vedgTools/QtXmlUtilities is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ vedgTools/QtXmlUtilities.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# include "CompactDocument.hpp"
+
+# include <QtCoreUtilities/Miscellaneous.hpp>
+
+# include <QtGlobal>
+# include <QByteArray>
+# include <QString>
+# include <QChar>
+# include <QFile>
+# include <QFileInfo>
+# include <QDir>
+# include <QDateTime>
+# include <QCryptographicHash>
+
+# if QT_VERSION >= QT_VERSION_CHECK(5, 1, 0)
+# include <QSaveFile>
+# endif
+
+# include <cstddef>
+# include <cstring>
+# include <memory>
+# include <utility>
+# include <vector>
+# include <type_traits>
+
+
+namespace QtUtilities
+{
+namespace XmlReading
+{
+namespace
+{
+static_assert(std::is_standard_layout<detail::CompactNode>::value &&
+              sizeof(detail::CompactNode) == 7 * sizeof(qint32),
+              "CompactNode can not be stored in a snapshot as is.");
+static_assert(std::is_standard_layout<detail::CompactAttribute>::value &&
+              sizeof(detail::CompactAttribute) == 3 * sizeof(qint32),
+              "CompactAttribute can not be stored in a snapshot as is.");
+
+constexpr char snapshotMagic[8] = { 'Q', 'X', 'U', 'C', 'D', 'O', 'C', 0 };
+constexpr quint32 snapshotVersion = 1;
+/// Is stored in native byte order; snapshots written on a machine with
+/// different byte order are rejected.
+constexpr quint32 byteOrderMark = 0x01020304;
+
+/// Snapshot file consists of this header followed by:
+/// nodes, attributes, lengths of names (qint32 each), characters of all
+/// names, characters of texts and characters of attribute values.
+struct SnapshotHeader {
+    char magic[8];
+    quint32 byteOrder;
+    quint32 version;
+    qint64 sourceSize;
+    qint64 sourceModified;
+    qint32 nodeCount;
+    qint32 attributeCount;
+    qint32 nameCount;
+    qint32 textsSize;
+    qint32 valuesSize;
+    qint32 reserved;
+};
+
+struct SourceKey {
+    explicit SourceKey(const QFileInfo & info)
+        : size(info.size()),
+          modified(info.lastModified().toMSecsSinceEpoch()) {}
+
+    qint64 size;
+    qint64 modified;
+};
+
+QString snapshotPath(const QString & filename, const QString & cacheDirectory)
+{
+    const QString suffix = QString::fromLatin1(".xmlcache");
+    if (cacheDirectory.isEmpty())
+        return filename + suffix;
+    const QByteArray pathHash = QCryptographicHash::hash(
+                                    QFileInfo(filename).absoluteFilePath().
+                                    toUtf8(), QCryptographicHash::Sha1);
+    return QDir(cacheDirectory).filePath(
+               QString::fromLatin1(pathHash.toHex()) + suffix);
+}
+
+/// @brief Sequential reader of the mapped snapshot.
+class SnapshotInput
+{
+public:
+    SnapshotInput(const uchar * data, qint64 size)
+        : position_(data), end_(data + size) {}
+
+    /// @brief Copies count objects of type T to destination.
+    /// @return false if the snapshot is too short.
+    template <typename T>
+    bool read(T * const destination, const qint64 count) {
+        if (count < 0 || (end_ - position_) / qint64(sizeof(T)) < count)
+            return false;
+        const std::size_t bytes = std::size_t(count) * sizeof(T);
+        if (bytes != 0)
+            std::memcpy(destination, position_, bytes);
+        position_ += bytes;
+        return true;
+    }
+
+    bool readString(QString & destination, const qint32 size) {
+        destination.resize(size);
+        return read(destination.data(), size);
+    }
+
+    bool atEnd() const { return position_ == end_; }
+
+private:
+    const uchar * position_;
+    const uchar * const end_;
+};
+
+/// @return true if link is -1 or refers to a node after the node at index.
+/// Links only go forward in document order, so a valid snapshot can not
+/// make traversal loop.
+bool isValidLink(const qint32 link, const std::size_t index,
+                 const std::size_t count)
+{
+    return link == -1 ||
+           (link > 0 && std::size_t(link) > index && std::size_t(link) < count);
+}
+
+bool isValidRange(const qint32 begin, const qint32 end, const qint32 size)
+{
+    return 0 <= begin && begin <= end && end <= size;
+}
+
+/// @return true if all indices in data are in bounds.
+bool isConsistent(const detail::CompactData & data)
+{
+    const std::size_t nameCount = data.names.size();
+    const std::size_t nodeCount = data.nodes.size();
+    for (std::size_t i = 0; i < nodeCount; ++i) {
+        const detail::CompactNode & node = data.nodes[i];
+        if (node.name < 0 || std::size_t(node.name) >= nameCount ||
+                ! isValidLink(node.firstChild, i, nodeCount) ||
+                ! isValidLink(node.nextSibling, i, nodeCount) ||
+                node.attributeCount < 0 || node.firstAttribute < 0 ||
+                std::size_t(node.firstAttribute) +
+                std::size_t(node.attributeCount) > data.attributes.size() ||
+                ! isValidRange(node.textBegin, node.textEnd,
+                               data.texts.size())) {
+            return false;
+        }
+    }
+    for (const detail::CompactAttribute & a : data.attributes) {
+        if (a.name < 0 || std::size_t(a.name) >= nameCount ||
+                ! isValidRange(a.valueBegin, a.valueEnd, data.values.size())) {
+            return false;
+        }
+    }
+    return ! data.nodes.empty();
+}
+
+/// @return Document data loaded from snapshot or nullptr if the snapshot
+/// does not exist, is stale or corrupt.
+std::shared_ptr<const detail::CompactData> readSnapshot(
+    const QString & path, const SourceKey & key)
+{
+    QFile file(path);
+    if (! file.open(QIODevice::ReadOnly))
+        return nullptr;
+    const qint64 size = file.size();
+    if (size < qint64(sizeof(SnapshotHeader)))
+        return nullptr;
+    const uchar * const mapped = file.map(0, size);
+    if (mapped == nullptr)
+        return nullptr;
+    SnapshotInput input(mapped, size);
+
+    SnapshotHeader header;
+    input.read(& header, 1);
+    if (std::memcmp(header.magic, snapshotMagic, sizeof snapshotMagic) != 0 ||
+            header.byteOrder != byteOrderMark ||
+            header.version != snapshotVersion ||
+            header.sourceSize != key.size ||
+            header.sourceModified != key.modified ||
+            header.nodeCount < 0 || header.attributeCount < 0 ||
+            header.nameCount < 0 || header.textsSize < 0 ||
+            header.valuesSize < 0) {
+        return nullptr;
+    }
+
+    auto data = std::make_shared<detail::CompactData>();
+    data->nodes.resize(std::size_t(header.nodeCount));
+    data->attributes.resize(std::size_t(header.attributeCount));
+    std::vector<qint32> nameSizes(std::size_t(header.nameCount));
+    if (! input.read(data->nodes.data(), header.nodeCount) ||
+            ! input.read(data->attributes.data(), header.attributeCount) ||
+            ! input.read(nameSizes.data(), header.nameCount)) {
+        return nullptr;
+    }
+    data->names.reserve(nameSizes.size());
+    for (const qint32 nameSize : nameSizes) {
+        QString name;
+        if (nameSize < 0 || ! input.readString(name, nameSize))
+            return nullptr;
+        data->nameIndices.insert(name, qint32(data->names.size()));
+        data->names.push_back(name);
+    }
+    if (! input.readString(data->texts, header.textsSize) ||
+            ! input.readString(data->values, header.valuesSize) ||
+            ! input.atEnd() || ! isConsistent(*data)) {
+        return nullptr;
+    }
+    return data;
+}
+
+template <typename T>
+bool write(QIODevice & device, const T * const data, const std::size_t count)
+{
+    const qint64 bytes = qint64(count * sizeof(T));
+    return device.write(reinterpret_cast<const char *>(data), bytes) == bytes;
+}
+
+bool writeSnapshot(QIODevice & device, const detail::CompactData & data,
+                   const SourceKey & key)
+{
+    SnapshotHeader header;
+    std::memcpy(header.magic, snapshotMagic, sizeof snapshotMagic);
+    header.byteOrder = byteOrderMark;
+    header.version = snapshotVersion;
+    header.sourceSize = key.size;
+    header.sourceModified = key.modified;
+    header.nodeCount = qint32(data.nodes.size());
+    header.attributeCount = qint32(data.attributes.size());
+    header.nameCount = qint32(data.names.size());
+    header.textsSize = data.texts.size();
+    header.valuesSize = data.values.size();
+    header.reserved = 0;
+
+    std::vector<qint32> nameSizes;
+    nameSizes.reserve(data.names.size());
+    for (const QString & name : data.names)
+        nameSizes.push_back(name.size());
+
+    if (! write(device, & header, 1) ||
+            ! write(device, data.nodes.data(), data.nodes.size()) ||
+            ! write(device, data.attributes.data(), data.attributes.size()) ||
+            ! write(device, nameSizes.data(), nameSizes.size())) {
+        return false;
+    }
+    for (const QString & name : data.names) {
+        if (! write(device, name.constData(), std::size_t(name.size())))
+            return false;
+    }
+    return write(device, data.texts.constData(),
+                 std::size_t(data.texts.size())) &&
+           write(device, data.values.constData(),
+                 std::size_t(data.values.size()));
+}
+
+/// @brief Writes snapshot of data to path. Errors are ignored: a missing
+/// snapshot only makes the next loading slower.
+void saveSnapshot(const QString & path, const detail::CompactData & data,
+                  const SourceKey & key)
+{
+    try {
+        makePathTo(path);
+    }
+    catch (...) {
+        return;
+    }
+# if QT_VERSION >= QT_VERSION_CHECK(5, 1, 0)
+    QSaveFile file(path);
+    if (file.open(QIODevice::WriteOnly) && writeSnapshot(file, data, key))
+        file.commit();
+# else
+    QFile file(path);
+    if (file.open(QIODevice::WriteOnly) && ! writeSnapshot(file, data, key))
+        file.remove();
+# endif
+}
+
+} // END unnamed namespace
+
+
+CompactDocument loadCompactDocumentCached(const QString & filename,
+        const QString & cacheDirectory)
+{
+    const SourceKey key { QFileInfo(filename) };
+    const QString path = snapshotPath(filename, cacheDirectory);
+    if (auto data = readSnapshot(path, key))
+        return CompactDocument(std::move(data));
+
+    CompactDocument document = loadCompactDocument(filename);
+    if (document.data_ != nullptr)
+        saveSnapshot(path, *document.data_, key);
+    return document;
+}
+
+} // END namespace XmlReading
+} // END namespace QtUtilities
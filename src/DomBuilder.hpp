@@ -0,0 +1,114 @@
+/*
+ This file is part of vedgTools/QtXmlUtilities.
+ Copyright (C) 2014, 2015 Igor Kushnir <igorkuo AT Google mail>
+
+ vedgTools/QtXmlUtilities is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ vedgTools/QtXmlUtilities is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ vedgTools/QtXmlUtilities.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# ifndef QT_XML_UTILITIES_DOM_BUILDER_HPP
+# define QT_XML_UTILITIES_DOM_BUILDER_HPP
+
+# include <QString>
+# include <QXmlStreamReader>
+# include <QXmlStreamAttributes>
+# include <QDomDocument>
+# include <QDomElement>
+# include <QDomNode>
+
+
+namespace QtUtilities
+{
+namespace XmlReading
+{
+namespace detail
+{
+/// @brief Builds a QDomDocument from the tokens of QXmlStreamReader. The
+/// result is the same as the one of QDomDocument::setContent() without
+/// namespace processing: comments, processing instructions and
+/// whitespace-only texts are dropped.
+class DomBuilder
+{
+public:
+    DomBuilder() : depth_(0) {}
+
+    /// @return true if no element has been started since the last reset().
+    bool isEmpty() const { return doc_.isNull(); }
+
+    /// @brief Adds the current token of xml to the document.
+    /// @return true if the token has closed the root element.
+    bool process(const QXmlStreamReader & xml) {
+        switch (xml.tokenType()) {
+            case QXmlStreamReader::StartElement:
+                startElement(xml);
+                return false;
+            case QXmlStreamReader::EndElement:
+                current_ = current_.parentNode();
+                return --depth_ == 0;
+            case QXmlStreamReader::Characters:
+                if (depth_ != 0)
+                    characters(xml);
+                return false;
+            default:
+                return false;
+        }
+    }
+
+    /// @return Root element of the document being built.
+    QDomElement root() const { return doc_.documentElement(); }
+
+    /// @brief Releases the document and prepares for building a new one.
+    void reset() {
+        current_.clear();
+        doc_ = QDomDocument();
+        depth_ = 0;
+    }
+
+    int depth() const { return depth_; }
+
+private:
+    void startElement(const QXmlStreamReader & xml) {
+        if (doc_.isNull())
+            doc_ = QDomDocument(QString());
+        QDomElement e = doc_.createElement(xml.qualifiedName().toString());
+        for (const QXmlStreamAttribute & a : xml.attributes()) {
+            e.setAttribute(a.qualifiedName().toString(),
+                           a.value().toString());
+        }
+        if (depth_ == 0)
+            doc_.appendChild(e);
+        else
+            current_.appendChild(e);
+        current_ = e;
+        ++depth_;
+    }
+
+    void characters(const QXmlStreamReader & xml) {
+        if (xml.isCDATA()) {
+            current_.appendChild(
+                doc_.createCDATASection(xml.text().toString()));
+        }
+        else if (! xml.isWhitespace())
+            current_.appendChild(doc_.createTextNode(xml.text().toString()));
+    }
+
+    QDomDocument doc_;
+    QDomNode current_;
+    int depth_;
+};
+
+} // END namespace detail
+} // END namespace XmlReading
+} // END namespace QtUtilities
+
+# endif // QT_XML_UTILITIES_DOM_BUILDER_HPP
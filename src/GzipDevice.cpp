@@ -0,0 +1,257 @@
+/*
+ This file is part of vedgTools/QtXmlUtilities.
+ Copyright (C) 2014, 2015 Igor Kushnir <igorkuo AT Google mail>
+
+ vedgTools/QtXmlUtilities is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ vedgTools/QtXmlUtilities is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ vedgTools/QtXmlUtilities.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# include "GzipDevice.hpp"
+
+# include <QByteArray>
+# include <QString>
+# include <QLatin1String>
+# include <QObject>
+
+# ifdef QT_XML_UTILITIES_ZLIB
+# include <zlib.h>
+# endif
+
+# include <algorithm>
+# include <limits>
+
+
+namespace QtUtilities
+{
+namespace
+{
+constexpr int bufferSize = 64 * 1024;
+}
+
+# ifdef QT_XML_UTILITIES_ZLIB
+struct GzipDevice::Stream {
+    Stream() : compressing(false), ended(false), finished(false) {
+        z.zalloc = Z_NULL;
+        z.zfree = Z_NULL;
+        z.opaque = Z_NULL;
+        z.next_in = Z_NULL;
+        z.avail_in = 0;
+    }
+
+    ~Stream() {
+        if (compressing)
+            deflateEnd(& z);
+        else
+            inflateEnd(& z);
+    }
+
+    z_stream z;
+    /// Compressed data: input in ReadOnly mode, output in WriteOnly mode.
+    QByteArray buffer;
+    bool compressing;
+    /// In ReadOnly mode: the end of the gzip stream was reached.
+    bool ended;
+    /// In WriteOnly mode: finish() was called.
+    bool finished;
+};
+# else
+struct GzipDevice::Stream {};
+# endif
+
+GzipDevice::GzipDevice(QIODevice & device) : device_(device)
+{
+}
+
+GzipDevice::~GzipDevice()
+{
+    close();
+}
+
+bool GzipDevice::open(const OpenMode mode)
+{
+    if (mode != QIODevice::ReadOnly && mode != QIODevice::WriteOnly) {
+        setErrorString(QObject::tr("only ReadOnly and WriteOnly modes are "
+                                   "supported."));
+        return false;
+    }
+# ifdef QT_XML_UTILITIES_ZLIB
+    std::unique_ptr<Stream> stream(new Stream);
+    // 16 selects gzip format for deflate; 32 makes inflate detect zlib or
+    // gzip header automatically.
+    int result;
+    if (mode == QIODevice::WriteOnly) {
+        result = deflateInit2(& stream->z, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                              MAX_WBITS + 16, 8, Z_DEFAULT_STRATEGY);
+        stream->compressing = true;
+        stream->buffer.resize(bufferSize);
+    }
+    else
+        result = inflateInit2(& stream->z, MAX_WBITS + 32);
+    if (result != Z_OK) {
+        stream->compressing = false;
+        stream->z.state = Z_NULL;
+        setErrorString(QObject::tr("could not initialize zlib."));
+        return false;
+    }
+    stream_ = std::move(stream);
+    return QIODevice::open(mode);
+# else
+    setErrorString(QObject::tr("gzip support is disabled in this build."));
+    return false;
+# endif
+}
+
+void GzipDevice::close()
+{
+    if (! isOpen())
+        return;
+    if (openMode() == QIODevice::WriteOnly)
+        finish();
+    QIODevice::close();
+    stream_.reset();
+}
+
+bool GzipDevice::finish()
+{
+# ifdef QT_XML_UTILITIES_ZLIB
+    if (stream_ == nullptr || ! stream_->compressing)
+        return false;
+    if (stream_->finished)
+        return true;
+    stream_->finished = true;
+    z_stream & z = stream_->z;
+    z.next_in = Z_NULL;
+    z.avail_in = 0;
+    int result;
+    do {
+        z.next_out = reinterpret_cast<Bytef *>(stream_->buffer.data());
+        z.avail_out = uInt(bufferSize);
+        result = deflate(& z, Z_FINISH);
+        if (result == Z_STREAM_ERROR)
+            return false;
+        const qint64 produced = bufferSize - qint64(z.avail_out);
+        if (device_.write(stream_->buffer.constData(), produced) != produced)
+            return false;
+    } while (result != Z_STREAM_END);
+    return true;
+# else
+    return false;
+# endif
+}
+
+bool GzipDevice::atEnd() const
+{
+# ifdef QT_XML_UTILITIES_ZLIB
+    if (stream_ != nullptr && ! stream_->compressing && ! stream_->ended)
+        return false;
+# endif
+    return QIODevice::atEnd();
+}
+
+bool GzipDevice::isSupported()
+{
+# ifdef QT_XML_UTILITIES_ZLIB
+    return true;
+# else
+    return false;
+# endif
+}
+
+bool GzipDevice::isGzipped(QIODevice & device)
+{
+    return device.peek(2) == QByteArray("\x1f\x8b", 2);
+}
+
+bool GzipDevice::hasGzipSuffix(const QString & filename)
+{
+    return filename.endsWith(QLatin1String(".gz"), Qt::CaseInsensitive);
+}
+
+qint64 GzipDevice::readData(char * const data, const qint64 maxSize)
+{
+# ifdef QT_XML_UTILITIES_ZLIB
+    if (stream_ == nullptr || stream_->ended || maxSize <= 0)
+        return stream_ == nullptr ? -1 : 0;
+    z_stream & z = stream_->z;
+    z.next_out = reinterpret_cast<Bytef *>(data);
+    z.avail_out = uInt(std::min<qint64>(maxSize,
+                                        std::numeric_limits<uInt>::max()));
+    const uInt capacity = z.avail_out;
+    while (z.avail_out == capacity) {
+        if (z.avail_in == 0) {
+            stream_->buffer = device_.read(bufferSize);
+            if (stream_->buffer.isEmpty()) {
+                if (! device_.atEnd())
+                    break; // No data available yet.
+                setErrorString(QObject::tr("unexpected end of gzip data."));
+                return -1;
+            }
+            z.next_in = reinterpret_cast<Bytef *>(stream_->buffer.data());
+            z.avail_in = uInt(stream_->buffer.size());
+        }
+        const int result = inflate(& z, Z_NO_FLUSH);
+        if (result == Z_STREAM_END) {
+            stream_->ended = true;
+            break;
+        }
+        if (result != Z_OK && result != Z_BUF_ERROR) {
+            setErrorString(QObject::tr("corrupt gzip data."));
+            return -1;
+        }
+    }
+    return qint64(capacity - z.avail_out);
+# else
+    Q_UNUSED(data)
+    Q_UNUSED(maxSize)
+    return -1;
+# endif
+}
+
+qint64 GzipDevice::writeData(const char * const data, const qint64 size)
+{
+# ifdef QT_XML_UTILITIES_ZLIB
+    if (stream_ == nullptr || stream_->finished)
+        return -1;
+    z_stream & z = stream_->z;
+    qint64 remaining = size;
+    const char * input = data;
+    while (remaining > 0) {
+        const uInt chunk = uInt(
+            std::min<qint64>(remaining, std::numeric_limits<uInt>::max()));
+        z.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(input));
+        z.avail_in = chunk;
+        do {
+            z.next_out = reinterpret_cast<Bytef *>(stream_->buffer.data());
+            z.avail_out = uInt(bufferSize);
+            if (deflate(& z, Z_NO_FLUSH) == Z_STREAM_ERROR)
+                return -1;
+            const qint64 produced = bufferSize - qint64(z.avail_out);
+            if (produced != 0 &&
+                    device_.write(stream_->buffer.constData(), produced) !=
+                    produced) {
+                setErrorString(device_.errorString());
+                return -1;
+            }
+        } while (z.avail_out == 0);
+        input += chunk;
+        remaining -= chunk;
+    }
+    return size;
+# else
+    Q_UNUSED(data)
+    Q_UNUSED(size)
+    return -1;
+# endif
+}
+
+} // END namespace QtUtilities
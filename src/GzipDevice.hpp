@@ -0,0 +1,79 @@
+/*
+ This file is part of vedgTools/QtXmlUtilities.
+ Copyright (C) 2014, 2015 Igor Kushnir <igorkuo AT Google mail>
+
+ vedgTools/QtXmlUtilities is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ vedgTools/QtXmlUtilities is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ vedgTools/QtXmlUtilities.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# ifndef QT_XML_UTILITIES_GZIP_DEVICE_HPP
+# define QT_XML_UTILITIES_GZIP_DEVICE_HPP
+
+# include <QtGlobal>
+# include <QIODevice>
+
+# include <memory>
+
+
+QT_FORWARD_DECLARE_CLASS(QString)
+
+namespace QtUtilities
+{
+/// @brief Sequential device, which decompresses gzip data read from another
+/// device (ReadOnly mode) or compresses data written to it into another
+/// device (WriteOnly mode) on the fly.
+/// NOTE: gzip support requires building with zlib (the
+/// QT_XML_UTILITIES_WITH_ZLIB CMake option); otherwise open() always fails.
+class GzipDevice : public QIODevice
+{
+public:
+    /// @param device Must be open in the mode, in which this device is going
+    /// to be opened, and must outlive this device.
+    explicit GzipDevice(QIODevice & device);
+    /// @brief Calls close().
+    ~GzipDevice() override;
+
+    /// @brief Opens the device in ReadOnly or WriteOnly mode.
+    bool open(OpenMode mode) override;
+    /// @brief In WriteOnly mode calls finish() first, errors are ignored.
+    void close() override;
+    /// @brief Compresses and writes all remaining data and the gzip trailer
+    /// to the underlying device. No more data may be written after this call.
+    /// @return true on success.
+    bool finish();
+
+    bool isSequential() const override { return true; }
+    bool atEnd() const override;
+
+    /// @return true if this library is built with gzip support.
+    static bool isSupported();
+    /// @return true if the data available in device starts with gzip magic
+    /// bytes. device must be open for reading; no data is consumed.
+    static bool isGzipped(QIODevice & device);
+    /// @return true if filename ends with ".gz".
+    static bool hasGzipSuffix(const QString & filename);
+
+protected:
+    qint64 readData(char * data, qint64 maxSize) override;
+    qint64 writeData(const char * data, qint64 size) override;
+
+private:
+    struct Stream;
+
+    QIODevice & device_;
+    std::unique_ptr<Stream> stream_;
+};
+
+} // END namespace QtUtilities
+
+# endif // QT_XML_UTILITIES_GZIP_DEVICE_HPP
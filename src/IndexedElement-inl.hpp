@@ -0,0 +1,71 @@
+/*
+ This file is part of vedgTools/QtXmlUtilities.
+ Copyright (C) 2014, 2015 Igor Kushnir <igorkuo AT Google mail>
+
+ vedgTools/QtXmlUtilities is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ vedgTools/QtXmlUtilities is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ vedgTools/QtXmlUtilities.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# ifndef QT_XML_UTILITIES_INDEXED_ELEMENT_INL_HPP
+# define QT_XML_UTILITIES_INDEXED_ELEMENT_INL_HPP
+
+# include <QtXmlUtilities/IndexedElement.hpp>
+
+# include <TemplateUtilities/Reserve.hpp>
+
+# include <QString>
+# include <QDomElement>
+
+# include <utility>
+
+
+namespace QtUtilities
+{
+namespace XmlReading
+{
+template <class QDomElementCollection>
+QDomElementCollection getChildren(const IndexedElement & e,
+                                  const QString & tagName)
+{
+    QDomElementCollection children;
+    TemplateUtilities::reserve(
+        children, static_cast<typename QDomElementCollection::size_type>(
+            e.childCount(tagName)));
+    detail::LookupScan scan;
+    for (QDomElement child = scan.indexed(e.firstChildElement(tagName));
+            ! child.isNull(); child = scan.next(children.back(), tagName)) {
+        children.push_back(std::move(child));
+    }
+    return children;
+}
+
+template <class TCollection, typename ElementToT>
+TCollection getChildren(const IndexedElement & e, const QString & tagName,
+                        ElementToT childToResultValue)
+{
+    TCollection converted;
+    TemplateUtilities::reserve(converted,
+                               static_cast<typename TCollection::size_type>(
+                                   e.childCount(tagName)));
+    detail::LookupScan scan;
+    for (QDomElement child = scan.indexed(e.firstChildElement(tagName));
+            ! child.isNull(); child = scan.next(child, tagName)) {
+        converted.push_back(childToResultValue(child));
+    }
+    return converted;
+}
+
+} // END namespace XmlReading
+} // END namespace QtUtilities
+
+# endif // QT_XML_UTILITIES_INDEXED_ELEMENT_INL_HPP
@@ -0,0 +1,110 @@
+/*
+ This file is part of vedgTools/QtXmlUtilities.
+ Copyright (C) 2014, 2015 Igor Kushnir <igorkuo AT Google mail>
+
+ vedgTools/QtXmlUtilities is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ vedgTools/QtXmlUtilities is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ vedgTools/QtXmlUtilities.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# include "IndexedElement.hpp"
+
+# include <QtCoreUtilities/String.hpp>
+
+# include <QString>
+# include <QStringList>
+# include <QDomElement>
+
+
+namespace QtUtilities
+{
+namespace XmlReading
+{
+IndexedElement::IndexedElement(const QDomElement & element)
+    : element_(element)
+{
+    for (QDomElement child = element.firstChildElement(); ! child.isNull();
+            child = child.nextSiblingElement()) {
+        Children & children = children_[child.tagName()];
+        if (children.count++ == 0)
+            children.first = child;
+    }
+}
+
+
+QDomElement getUniqueChild(const IndexedElement & e, const QString & tagName)
+{
+    detail::LookupScan scan;
+    if (e.childCount(tagName) > 1)
+        detail::throwNotUniqueError(tagName);
+    return scan.indexed(e.firstChildElement(tagName));
+}
+
+bool copyElementsAttributeTo(
+    const IndexedElement & e, const QString & attributeName,
+    QString & destination)
+{
+    return copyElementsAttributeTo(e.element(), attributeName, destination);
+}
+
+bool copyUniqueChildsTextTo(const IndexedElement & e, const QString & tagName,
+                            QString & destination)
+{
+    const QDomElement child = getUniqueChild(e, tagName);
+    if (child.isNull())
+        return false;
+    destination = child.text();
+    return true;
+}
+
+bool copyUniqueChildsTextToByteArray(
+    const IndexedElement & e, const QString & tagName,
+    QByteArray & destination)
+{
+    QString text;
+    if (copyUniqueChildsTextTo(e, tagName, text)) {
+        destination = qStringToByteArray(text);
+        return true;
+    }
+    return false;
+}
+
+ReadStatus tryCopyUniqueChildsTextTo(
+    const IndexedElement & e, const QString & tagName,
+    QString & destination) noexcept
+{
+    detail::LookupScan scan;
+    const int count = e.childCount(tagName);
+    if (count == 0)
+        return ReadStatus(ReadStatus::Absent, tagName, false);
+    if (count > 1)
+        return ReadStatus(ReadStatus::NotUnique, tagName, false);
+    destination = scan.indexed(e.firstChildElement(tagName)).text();
+    return ReadStatus();
+}
+
+bool copyUniqueChildsStringListTo(
+    const IndexedElement & e, const QString & listTagName,
+    const QString & stringTagName, QStringList & destination)
+{
+    const QDomElement listElement = getUniqueChild(e, listTagName);
+    if (listElement.isNull())
+        return false;
+    destination = getChildren<QStringList>(listElement, stringTagName,
+    [](const QDomElement & de) {
+        return de.text();
+    });
+    return true;
+}
+
+} // END namespace XmlReading
+} // END namespace QtUtilities
@@ -0,0 +1,85 @@
+/*
+ This file is part of vedgTools/QtXmlUtilities.
+ Copyright (C) 2014, 2015 Igor Kushnir <igorkuo AT Google mail>
+
+ vedgTools/QtXmlUtilities is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ vedgTools/QtXmlUtilities is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ vedgTools/QtXmlUtilities.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# ifndef QT_XML_UTILITIES_LIMIT_CHECKER_HPP
+# define QT_XML_UTILITIES_LIMIT_CHECKER_HPP
+
+# include <QtXmlUtilities/Limits.hpp>
+
+# include <QtGlobal>
+# include <QXmlStreamReader>
+
+# include <vector>
+
+
+namespace QtUtilities
+{
+namespace XmlReading
+{
+namespace detail
+{
+/// @brief Checks the tokens of QXmlStreamReader against Limits.
+class LimitChecker
+{
+public:
+    explicit LimitChecker(const Limits & limits = Limits())
+        : limits_(limits), elementCount_(0) {}
+
+    const Limits & limits() const { return limits_; }
+    bool isUnlimited() const { return limits_.isUnlimited(); }
+
+    /// @throw LimitExceededError If bytes exceeds limits().maxInputBytes.
+    void checkInputBytes(qint64 bytes) const;
+
+    /// @brief Checks the current token of xml. Must be called for each token
+    /// in document order.
+    /// @throw LimitExceededError If a limit is exceeded.
+    void check(const QXmlStreamReader & xml) {
+        switch (xml.tokenType()) {
+            case QXmlStreamReader::StartElement:
+                startElement(xml);
+                break;
+            case QXmlStreamReader::EndElement:
+                textLengths_.pop_back();
+                break;
+            case QXmlStreamReader::Characters:
+                if (limits_.maxTextLength != 0)
+                    characters(xml);
+                break;
+            default:
+                break;
+        }
+    }
+
+private:
+    void startElement(const QXmlStreamReader & xml);
+    void characters(const QXmlStreamReader & xml);
+
+    Limits limits_;
+    qint64 elementCount_;
+    /// Length of the text directly inside each open element; the size is the
+    /// current depth. Text of an element is counted across its children, so
+    /// mixed content can not bypass maxTextLength.
+    std::vector<qint64> textLengths_;
+};
+
+} // END namespace detail
+} // END namespace XmlReading
+} // END namespace QtUtilities
+
+# endif // QT_XML_UTILITIES_LIMIT_CHECKER_HPP
@@ -0,0 +1,248 @@
+/*
+ This file is part of vedgTools/QtXmlUtilities.
+ Copyright (C) 2014, 2015 Igor Kushnir <igorkuo AT Google mail>
+
+ vedgTools/QtXmlUtilities is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ vedgTools/QtXmlUtilities is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ vedgTools/QtXmlUtilities.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# include "Limits.hpp"
+
+# include "LimitChecker.hpp"
+# include "DomBuilder.hpp"
+# include "GzipDevice.hpp"
+
+# include <QtXmlUtilities/Statistics.hpp>
+
+# include <QByteArray>
+# include <QString>
+# include <QObject>
+# include <QIODevice>
+# include <QFile>
+# include <QXmlStreamReader>
+# include <QXmlStreamAttributes>
+# include <QDomElement>
+# include <QElapsedTimer>
+
+
+namespace QtUtilities
+{
+namespace XmlReading
+{
+LimitExceededError::~LimitExceededError() noexcept = default;
+
+namespace detail
+{
+void LimitChecker::checkInputBytes(const qint64 bytes) const
+{
+    if (limits_.maxInputBytes != 0 && bytes > limits_.maxInputBytes) {
+        throw LimitExceededError(
+            LimitExceededError::InputBytes, limits_.maxInputBytes,
+            QObject::tr("input size limit of %1 bytes exceeded.").arg(
+                limits_.maxInputBytes));
+    }
+}
+
+void LimitChecker::startElement(const QXmlStreamReader & xml)
+{
+    textLengths_.push_back(0);
+    ++elementCount_;
+    if (limits_.maxDepth != 0 && int(textLengths_.size()) > limits_.maxDepth) {
+        throw LimitExceededError(
+            LimitExceededError::Depth, limits_.maxDepth,
+            QObject::tr("nesting depth limit of %1 exceeded at element %2.")
+            .arg(limits_.maxDepth).arg(xml.qualifiedName().toString()));
+    }
+    if (limits_.maxElementCount != 0 &&
+            elementCount_ > limits_.maxElementCount) {
+        throw LimitExceededError(
+            LimitExceededError::ElementCount, limits_.maxElementCount,
+            QObject::tr("element count limit of %1 exceeded.").arg(
+                limits_.maxElementCount));
+    }
+    if (limits_.maxAttributeLength != 0) {
+        for (const QXmlStreamAttribute & a : xml.attributes()) {
+            if (a.value().size() > limits_.maxAttributeLength) {
+                throw LimitExceededError(
+                    LimitExceededError::AttributeLength,
+                    limits_.maxAttributeLength,
+                    QObject::tr("length limit of %1 exceeded by attribute "
+                                "%2 of element %3.").arg(
+                        limits_.maxAttributeLength).arg(
+                        a.qualifiedName().toString(),
+                        xml.qualifiedName().toString()));
+            }
+        }
+    }
+}
+
+void LimitChecker::characters(const QXmlStreamReader & xml)
+{
+    // Whitespace outside of the root element is not element text.
+    if (textLengths_.empty())
+        return;
+    qint64 & textLength = textLengths_.back();
+    textLength += xml.text().size();
+    if (textLength > limits_.maxTextLength) {
+        throw LimitExceededError(
+            LimitExceededError::TextLength, limits_.maxTextLength,
+            QObject::tr("text length limit of %1 exceeded.").arg(
+                limits_.maxTextLength));
+    }
+}
+
+} // END namespace detail
+
+
+namespace
+{
+constexpr qint64 chunkSize = 64 * 1024;
+
+[[noreturn]] void throwParseError(const QXmlStreamReader & xml,
+                                  const QString & sourceName)
+{
+    const QString errorMsg = xml.hasError() ? xml.errorString() :
+                             QObject::tr("unexpected end of document");
+    throw ReadError(
+        QObject::tr("could not load XML document from %1."
+                    " On line %2 at column %3: %4.").arg(sourceName).arg(
+            xml.lineNumber()).arg(xml.columnNumber()).arg(errorMsg));
+}
+
+/// @brief Parses the document read in chunks by readChunk(), enforcing
+/// limits, and returns its root element.
+/// @tparam ReadChunk Must be a callable object that takes no parameters and
+/// returns the next QByteArray chunk of input or an empty array at the end.
+/// @param bytes Is set to the number of bytes read so far, even if an
+/// exception is thrown.
+template <typename ReadChunk>
+QDomElement parseChunks(ReadChunk & readChunk, const QString & sourceName,
+                        const Limits & limits, qint64 & bytes)
+{
+    detail::LimitChecker checker(limits);
+    detail::DomBuilder builder;
+    QXmlStreamReader xml;
+    xml.setNamespaceProcessing(false);
+    bytes = 0;
+    bool rootClosed = false;
+    while (true) {
+        const QXmlStreamReader::TokenType token = xml.readNext();
+        if (token == QXmlStreamReader::EndDocument)
+            break;
+        if (token == QXmlStreamReader::Invalid) {
+            if (xml.error() != QXmlStreamReader::PrematureEndOfDocumentError)
+                throwParseError(xml, sourceName);
+            const QByteArray chunk = readChunk();
+            if (chunk.isEmpty()) {
+                if (rootClosed)
+                    break;
+                throwParseError(xml, sourceName);
+            }
+            bytes += chunk.size();
+            checker.checkInputBytes(bytes);
+            xml.addData(chunk);
+            continue;
+        }
+        checker.check(xml);
+        if (builder.process(xml))
+            rootClosed = true;
+    }
+    return builder.root();
+}
+
+/// @brief Calls parseChunks() and records statistics of the call if they are
+/// enabled, as loadRoot() does.
+template <typename ReadChunk>
+QDomElement parse(ReadChunk readChunk, const QString & sourceName,
+                  const Limits & limits)
+{
+    qint64 bytes = 0;
+    if (! XmlStatistics::isEnabled())
+        return parseChunks(readChunk, sourceName, limits, bytes);
+    QElapsedTimer timer;
+    timer.start();
+    QDomElement root;
+    try {
+        root = parseChunks(readChunk, sourceName, limits, bytes);
+    }
+    catch (...) {
+        XmlStatistics::detail::recordLoad(sourceName, bytes, nullptr,
+                                          timer.nsecsElapsed());
+        throw;
+    }
+    XmlStatistics::detail::recordLoad(sourceName, bytes, & root,
+                                      timer.nsecsElapsed());
+    return root;
+}
+
+QDomElement parse(QIODevice & device, const QString & sourceName,
+                  const Limits & limits)
+{
+    return parse([&device] { return device.read(chunkSize); }, sourceName,
+                 limits);
+}
+
+} // END unnamed namespace
+
+
+QDomElement loadRoot(const QString & filename, const Limits & limits)
+{
+    if (limits.isUnlimited())
+        return loadRoot(filename);
+    QFile file(filename);
+    if (! file.open(QIODevice::ReadOnly)) {
+        throw ReadError(
+            QObject::tr("could not open file %1 for reading.").arg(filename));
+    }
+    const QString sourceName = QObject::tr("file %1").arg(filename);
+    if (! GzipDevice::isGzipped(file)) {
+        // Fail before reading anything if the size is known to be too big.
+        detail::LimitChecker(limits).checkInputBytes(file.size());
+        return parse(file, sourceName, limits);
+    }
+    GzipDevice gzip(file);
+    if (! gzip.open(QIODevice::ReadOnly)) {
+        throw ReadError(QObject::tr("could not decompress file %1: %2").arg(
+                            filename, gzip.errorString()));
+    }
+    return parse(gzip, sourceName, limits);
+}
+
+QDomElement loadRoot(QIODevice & device, const Limits & limits)
+{
+    if (limits.isUnlimited())
+        return loadRoot(device);
+    if (! device.isOpen() && ! device.open(QIODevice::ReadOnly))
+        throw ReadError(QObject::tr("could not open device for reading."));
+    if (! device.isSequential()) {
+        detail::LimitChecker(limits).checkInputBytes(device.size() -
+                                                     device.pos());
+    }
+    return parse(device, QObject::tr("device"), limits);
+}
+
+QDomElement loadRootFromData(const QByteArray & data, const Limits & limits)
+{
+    if (limits.isUnlimited())
+        return loadRootFromData(data);
+    bool read = false;
+    return parse([&data, &read]() -> QByteArray {
+        if (read)
+            return QByteArray();
+        read = true;
+        return data;
+    }, QObject::tr("data"), limits);
+}
+
+} // END namespace XmlReading
+} // END namespace QtUtilities
@@ -0,0 +1,146 @@
+/*
+ This file is part of vedgTools/QtXmlUtilities.
+ Copyright (C) 2014, 2015 Igor Kushnir <igorkuo AT Google mail>
+
+ vedgTools/QtXmlUtilities is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ vedgTools/QtXmlUtilities is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ vedgTools/QtXmlUtilities.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# ifndef QT_XML_UTILITIES_PARALLEL_READING_INL_HPP
+# define QT_XML_UTILITIES_PARALLEL_READING_INL_HPP
+
+# include <QtXmlUtilities/ParallelReading.hpp>
+
+# include "ThreadPool.hpp"
+
+# include <QtXmlUtilities/ReadingShortcuts.hpp>
+
+# include <QByteArray>
+# include <QString>
+# include <QStringList>
+# include <QThreadPool>
+# include <QDomElement>
+
+# include <cstddef>
+# include <exception>
+# include <utility>
+# include <iterator>
+# include <algorithm>
+# include <atomic>
+# include <vector>
+
+
+namespace QtUtilities
+{
+namespace XmlReading
+{
+template <typename Converter>
+std::vector<LoadResult<detail::ConverterResult<Converter>>> loadRoots(
+            const QStringList & filenames, const QString & tagName,
+            Converter converter, QThreadPool * const pool)
+{
+    std::vector<LoadResult<detail::ConverterResult<Converter>>> results(
+                filenames.size());
+    Parallel::forEachIndex(
+        pool == nullptr ? *QThreadPool::globalInstance() : *pool,
+        filenames.size(), [&](const int i) {
+        try {
+            results[i].value = converter(loadRoot(filenames[i], tagName));
+        }
+        catch (...) {
+            results[i].error = std::current_exception();
+        }
+    });
+    return results;
+}
+
+
+template <typename Converter>
+std::vector<detail::ConverterResult<Converter>> loadChildrenParallelFromData(
+            const QByteArray & data, const QString & rootTagName,
+            const QString & childTagName, Converter converter,
+            QThreadPool * const pool)
+{
+    typedef std::vector<detail::ConverterResult<Converter>> Results;
+    QThreadPool & threadPool =
+        pool == nullptr ? *QThreadPool::globalInstance() : *pool;
+    const detail::RecordChunks chunks(
+        data, detail::maxChunkCount(threadPool, data.size()));
+
+    // All chunks are parsed before converter is called for any child, so
+    // that falling back to sequential parsing does not call converter twice
+    // for the same child.
+    std::vector<QDomElement> roots(std::size_t(chunks.count()));
+    std::atomic<bool> parsingFailed(false);
+    Parallel::forEachIndex(threadPool, chunks.count(), [&](const int i) {
+        try {
+            QDomElement root = chunks.loadChunk(i);
+            assertTagName(root, rootTagName);
+            roots[std::size_t(i)] = std::move(root);
+        }
+        catch (...) {
+            parsingFailed = true;
+        }
+    });
+    if (parsingFailed) {
+        std::vector<QDomElement>().swap(roots);
+        return getChildren<Results>(loadRootFromData(data, rootTagName),
+                                    childTagName, std::move(converter));
+    }
+
+    std::vector<Results> chunkResults(roots.size());
+    std::vector<std::exception_ptr> errors(roots.size());
+    Parallel::forEachIndex(threadPool, chunks.count(), [&](const int i) {
+        QDomElement & root = roots[std::size_t(i)];
+        try {
+            chunkResults[std::size_t(i)] =
+                getChildren<Results>(root, childTagName, converter);
+        }
+        catch (...) {
+            errors[std::size_t(i)] = std::current_exception();
+        }
+        // Frees the chunk's document as soon as it is no longer needed.
+        root = QDomElement();
+    });
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < chunkResults.size(); ++i) {
+        if (errors[i])
+            std::rethrow_exception(errors[i]);
+        total += chunkResults[i].size();
+    }
+    if (chunkResults.size() == 1)
+        return std::move(chunkResults.front());
+    Results results;
+    results.reserve(total);
+    for (Results & chunk : chunkResults) {
+        std::move(chunk.begin(), chunk.end(), std::back_inserter(results));
+        Results().swap(chunk);
+    }
+    return results;
+}
+
+template <typename Converter>
+std::vector<detail::ConverterResult<Converter>> loadChildrenParallel(
+            const QString & filename, const QString & rootTagName,
+            const QString & childTagName, Converter converter,
+            QThreadPool * const pool)
+{
+    return loadChildrenParallelFromData(detail::readFile(filename),
+                                        rootTagName, childTagName,
+                                        std::move(converter), pool);
+}
+
+} // END namespace XmlReading
+} // END namespace QtUtilities
+
+# endif // QT_XML_UTILITIES_PARALLEL_READING_INL_HPP
@@ -0,0 +1,261 @@
+/*
+ This file is part of vedgTools/QtXmlUtilities.
+ Copyright (C) 2014, 2015 Igor Kushnir <igorkuo AT Google mail>
+
+ vedgTools/QtXmlUtilities is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ vedgTools/QtXmlUtilities is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ vedgTools/QtXmlUtilities.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# include "ParallelReading.hpp"
+
+# include <QByteArray>
+# include <QString>
+# include <QObject>
+# include <QFile>
+# include <QThreadPool>
+# include <QDomElement>
+
+# include <cstring>
+# include <algorithm>
+# include <utility>
+# include <vector>
+
+
+namespace QtUtilities
+{
+namespace XmlReading
+{
+namespace
+{
+/// Documents smaller than this are not worth splitting.
+constexpr int minChunkSize = 256 * 1024;
+
+bool startsWith(const QByteArray & data, const int position,
+                const char * const prefix)
+{
+    // QByteArray data is always null-terminated.
+    return std::strncmp(data.constData() + position, prefix,
+                        std::strlen(prefix)) == 0;
+}
+
+/// @return Position after the first occurrence of terminator at or after
+/// from or -1 if there is no such occurrence.
+int skipPast(const QByteArray & data, const int from,
+             const char * const terminator)
+{
+    const int position = data.indexOf(terminator, from);
+    return position == -1 ? -1 : position + int(std::strlen(terminator));
+}
+
+/// @return Position after '>', which ends the tag started at from, or -1.
+int skipTag(const QByteArray & data, const int from)
+{
+    char quote = 0;
+    for (int i = from; i < data.size(); ++i) {
+        const char c = data[i];
+        if (quote != 0) {
+            if (c == quote)
+                quote = 0;
+        }
+        else if (c == '"' || c == '\'')
+            quote = c;
+        else if (c == '>')
+            return i + 1;
+    }
+    return -1;
+}
+
+/// @return Position after the DOCTYPE declaration started at from or -1.
+int skipDoctype(const QByteArray & data, const int from)
+{
+    char quote = 0;
+    int brackets = 0;
+    for (int i = from; i < data.size(); ++i) {
+        const char c = data[i];
+        if (quote != 0) {
+            if (c == quote)
+                quote = 0;
+        }
+        else if (c == '"' || c == '\'')
+            quote = c;
+        else if (c == '[')
+            ++brackets;
+        else if (c == ']')
+            --brackets;
+        else if (c == '>' && brackets == 0)
+            return i + 1;
+    }
+    return -1;
+}
+
+bool isAsciiCompatible(const QByteArray & data)
+{
+    if (data.size() < 2)
+        return false;
+    const uchar first = uchar(data[0]), second = uchar(data[1]);
+    return first != 0 && second != 0 &&
+           !(first == 0xFE && second == 0xFF) &&
+           !(first == 0xFF && second == 0xFE);
+}
+
+struct Prescan {
+    /// Position after the root start tag.
+    int rootStartEnd;
+    /// Position of the root end tag.
+    int rootEndTag;
+    /// Byte ranges of top-level elements.
+    std::vector<std::pair<int, int>> records;
+};
+
+/// @return true if the structure of data was recognized.
+bool prescan(const QByteArray & data, Prescan & result)
+{
+    if (! isAsciiCompatible(data))
+        return false;
+    int depth = 0;
+    int i = 0;
+    while (true) {
+        i = data.indexOf('<', i);
+        if (i == -1 || i + 1 >= data.size())
+            return false;
+        int next;
+        const char c = data[i + 1];
+        if (c == '!') {
+            if (startsWith(data, i, "<!--"))
+                next = skipPast(data, i + 4, "-->");
+            else if (startsWith(data, i, "<![CDATA["))
+                next = skipPast(data, i + 9, "]]>");
+            else if (depth == 0)
+                next = skipDoctype(data, i);
+            else
+                return false;
+        }
+        else if (c == '?')
+            next = skipPast(data, i + 2, "?>");
+        else if (c == '/') {
+            next = skipTag(data, i);
+            if (next == -1 || --depth < 0)
+                return false;
+            if (depth == 1)
+                result.records.back().second = next;
+            else if (depth == 0) {
+                result.rootEndTag = i;
+                return true;
+            }
+        }
+        else {
+            next = skipTag(data, i);
+            if (next == -1)
+                return false;
+            const bool empty = data[next - 2] == '/';
+            if (depth == 0) {
+                // A root without children can not be split.
+                if (empty)
+                    return false;
+                result.rootStartEnd = next;
+            }
+            else if (depth == 1)
+                result.records.emplace_back(i, empty ? next : -1);
+            if (! empty)
+                ++depth;
+        }
+        if (next == -1)
+            return false;
+        i = next;
+    }
+}
+
+} // END unnamed namespace
+
+
+namespace detail
+{
+RecordChunks::RecordChunks(const QByteArray & data, const int maxChunkCount)
+    : data_(data)
+{
+    Prescan scan;
+    if (maxChunkCount < 2 || ! prescan(data, scan) || scan.records.size() < 2) {
+        ranges_.emplace_back(0, data.size());
+        return;
+    }
+    prefix_ = data.left(scan.rootStartEnd);
+    suffix_ = data.mid(scan.rootEndTag);
+
+    const int recordsBegin = scan.records.front().first;
+    const int targetSize = std::max(
+                               1, (scan.records.back().second - recordsBegin) /
+                               maxChunkCount);
+    int chunkBegin = recordsBegin;
+    for (const auto & record : scan.records) {
+        if (record.second - chunkBegin >= targetSize) {
+            ranges_.emplace_back(chunkBegin, record.second);
+            chunkBegin = record.second;
+        }
+    }
+    if (ranges_.empty() || ranges_.back().second != scan.records.back().second)
+        ranges_.emplace_back(chunkBegin, scan.records.back().second);
+}
+
+QDomElement RecordChunks::loadChunk(const int index) const
+{
+    const std::pair<int, int> & range = ranges_[std::size_t(index)];
+    if (prefix_.isEmpty())
+        return loadRootFromData(data_);
+    QByteArray chunk;
+    chunk.reserve(prefix_.size() + range.second - range.first +
+                  suffix_.size());
+    chunk += prefix_;
+    chunk.append(data_.constData() + range.first, range.second - range.first);
+    chunk += suffix_;
+    return loadRootFromData(chunk);
+}
+
+int maxChunkCount(const QThreadPool & pool, const int dataSize)
+{
+    return std::min(pool.maxThreadCount() * 4,
+                    std::max(1, dataSize / minChunkSize));
+}
+
+QByteArray readFile(const QString & filename)
+{
+    QFile file(filename);
+    if (! file.open(QIODevice::ReadOnly)) {
+        throw ReadError(
+            QObject::tr("could not open file %1 for reading.").arg(filename));
+    }
+    return file.readAll();
+}
+
+} // END namespace detail
+
+
+std::vector<QDomElement> loadChildrenParallelFromData(
+    const QByteArray & data, const QString & rootTagName,
+    const QString & childTagName, QThreadPool * const pool)
+{
+    return loadChildrenParallelFromData(data, rootTagName, childTagName,
+    [](const QDomElement & child) {
+        return child;
+    }, pool);
+}
+
+std::vector<QDomElement> loadChildrenParallel(
+    const QString & filename, const QString & rootTagName,
+    const QString & childTagName, QThreadPool * const pool)
+{
+    return loadChildrenParallelFromData(detail::readFile(filename),
+                                        rootTagName, childTagName, pool);
+}
+
+} // END namespace XmlReading
+} // END namespace QtUtilities
@@ -0,0 +1,106 @@
+/*
+ This file is part of vedgTools/QtXmlUtilities.
+ Copyright (C) 2014, 2015 Igor Kushnir <igorkuo AT Google mail>
+
+ vedgTools/QtXmlUtilities is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ vedgTools/QtXmlUtilities is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ vedgTools/QtXmlUtilities.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# ifndef QT_XML_UTILITIES_PATH_QUERY_INL_HPP
+# define QT_XML_UTILITIES_PATH_QUERY_INL_HPP
+
+# include <QtXmlUtilities/PathQuery.hpp>
+
+# include <QtXmlUtilities/ReadingShortcuts.hpp>
+
+# include <QString>
+
+# include <utility>
+
+
+namespace QtUtilities
+{
+namespace XmlReading
+{
+template <class TElement>
+TElement PathQuery::element(const TElement & e) const
+{
+    TElement current = e;
+    for (const Step & step : steps_) {
+        TElement child = current.firstChildElement(step.tagName);
+        if (step.index == 0) {
+            if (! child.isNull() &&
+                    ! child.nextSiblingElement(step.tagName).isNull()) {
+                detail::throwNotUniqueError(step.tagName);
+            }
+        }
+        else {
+            for (int i = 1; i < step.index && ! child.isNull(); ++i)
+                child = child.nextSiblingElement(step.tagName);
+        }
+        if (child.isNull())
+            return child;
+        current = std::move(child);
+    }
+    return current;
+}
+
+template <class TElement>
+bool PathQuery::copyTo(const TElement & e, QString & destination) const
+{
+    const TElement selected = element(e);
+    if (selected.isNull())
+        return false;
+    if (! hasAttribute()) {
+        destination = selected.text();
+        return true;
+    }
+    if (! selected.hasAttribute(attribute_))
+        return false;
+    destination = selected.attribute(attribute_);
+    return true;
+}
+
+template <typename T, class TElement>
+bool PathQuery::copyTo(const TElement & e, T & destination) const
+{
+    QString value;
+    if (copyTo(e, value)) {
+        destination = convert<T>(value);
+        return true;
+    }
+    return false;
+}
+
+template <typename T>
+bool PathQuery::read(StreamReader & reader, T & destination) const
+{
+    QString value;
+    if (read(reader, value)) {
+        destination = convert<T>(value);
+        return true;
+    }
+    return false;
+}
+
+template <typename T>
+T PathQuery::convert(const QString & value) const
+{
+    return hasAttribute() ? detail::convertAttribute<T>(value, path_) :
+           detail::convertText<T>(value, path_);
+}
+
+} // END namespace XmlReading
+} // END namespace QtUtilities
+
+# endif // QT_XML_UTILITIES_PATH_QUERY_INL_HPP
@@ -0,0 +1,136 @@
+/*
+ This file is part of vedgTools/QtXmlUtilities.
+ Copyright (C) 2014, 2015 Igor Kushnir <igorkuo AT Google mail>
+
+ vedgTools/QtXmlUtilities is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ vedgTools/QtXmlUtilities is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ vedgTools/QtXmlUtilities.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# include "PathQuery.hpp"
+
+# include "StreamReading.hpp"
+
+# include <QString>
+# include <QStringList>
+# include <QObject>
+
+# include <cstddef>
+# include <utility>
+
+
+namespace QtUtilities
+{
+namespace XmlReading
+{
+namespace
+{
+[[noreturn]] void throwInvalidPath(const QString & path)
+{
+    throw ReadError(QObject::tr("invalid path expression \"%1\".").arg(path));
+}
+
+bool isValidName(const QString & name)
+{
+    if (name.isEmpty())
+        return false;
+    for (const QChar c : name) {
+        if (c.isSpace() || c == QLatin1Char('[') || c == QLatin1Char(']') ||
+                c == QLatin1Char('@') || c == QLatin1Char('/')) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // END unnamed namespace
+
+
+PathQuery::PathQuery(const QString & path) : path_(path)
+{
+    QString stepsPart = path;
+    const int at = path.indexOf(QLatin1Char('@'));
+    if (at != -1) {
+        attribute_ = path.mid(at + 1);
+        if (! isValidName(attribute_))
+            throwInvalidPath(path);
+        stepsPart.truncate(at);
+    }
+    if (stepsPart.isEmpty())
+        return;
+
+    const QStringList parts = stepsPart.split(QLatin1Char('/'));
+    steps_.reserve(std::size_t(parts.size()));
+    for (const QString & part : parts) {
+        Step step { part, 0 };
+        const int bracket = part.indexOf(QLatin1Char('['));
+        if (bracket != -1) {
+            if (! part.endsWith(QLatin1Char(']')))
+                throwInvalidPath(path);
+            bool ok;
+            step.index = part.mid(bracket + 1,
+                                  part.size() - bracket - 2).toInt(& ok);
+            if (! ok || step.index < 1)
+                throwInvalidPath(path);
+            step.tagName.truncate(bracket);
+        }
+        if (! isValidName(step.tagName))
+            throwInvalidPath(path);
+        steps_.push_back(std::move(step));
+    }
+}
+
+bool PathQuery::read(StreamReader & reader, QString & destination) const
+{
+    QString value;
+    if (readFrom(reader, 0, value)) {
+        destination = std::move(value);
+        return true;
+    }
+    return false;
+}
+
+bool PathQuery::readFrom(StreamReader & reader, const std::size_t stepIndex,
+                         QString & destination) const
+{
+    if (stepIndex == steps_.size()) {
+        if (! hasAttribute()) {
+            destination = reader.readText();
+            return true;
+        }
+        const bool copied =
+            reader.copyElementsAttributeTo(attribute_, destination);
+        reader.skipElement();
+        return copied;
+    }
+
+    const Step & step = steps_[stepIndex];
+    bool matched = false;
+    bool copied = false;
+    int seen = 0;
+    reader.readChildren([&](StreamReader & child) {
+        if (! child.hasTagName(step.tagName))
+            return;
+        if (step.index == 0) {
+            if (matched)
+                detail::throwNotUniqueError(step.tagName);
+            matched = true;
+        }
+        else if (++seen != step.index)
+            return;
+        copied = readFrom(child, stepIndex + 1, destination);
+    });
+    return copied;
+}
+
+} // END namespace XmlReading
+} // END namespace QtUtilities
@@ -0,0 +1,171 @@
+/*
+ This file is part of vedgTools/QtXmlUtilities.
+ Copyright (C) 2014, 2015 Igor Kushnir <igorkuo AT Google mail>
+
+ vedgTools/QtXmlUtilities is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ vedgTools/QtXmlUtilities is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ vedgTools/QtXmlUtilities.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# ifndef QT_XML_UTILITIES_READ_RESULT_INL_HPP
+# define QT_XML_UTILITIES_READ_RESULT_INL_HPP
+
+# include <QtXmlUtilities/ReadResult.hpp>
+# include <QtXmlUtilities/Statistics.hpp>
+
+# include <QtCoreUtilities/String.hpp>
+
+# include <QString>
+
+# include <utility>
+
+
+namespace QtUtilities
+{
+namespace XmlReading
+{
+namespace detail
+{
+/// @brief Converts text to type T without throwing. Uses the same
+/// conversion as the throwing shortcuts (ConvertQString::to<T>), so both
+/// accept and reject exactly the same texts.
+/// @return true if text was converted and stored in destination.
+template <typename T>
+bool tryConvert(const QString & text, T & destination) noexcept
+{
+    try {
+        destination = ConvertQString::to<T>(text);
+        return true;
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+inline bool tryConvert(const QString & text, QString & destination) noexcept
+{
+    destination = text;
+    return true;
+}
+
+/// @brief Implements the converting and validating tryCopyUniqueChildsTextTo.
+template <typename T, typename Predicate, class TElement>
+ReadStatus tryCopyConvertedText(
+    const TElement & e, const QString & tagName, T & destination,
+    Predicate & isValid) noexcept
+{
+    static_assert(IsElement<TElement>::value,
+                  "TElement is not supported by XmlReading shortcuts.");
+    QString text;
+    const ReadStatus status = tryCopyUniqueChildsTextTo(e, tagName, text);
+    if (! status.ok())
+        return status;
+    T value;
+    if (! tryConvert(text, value)) {
+        XmlStatistics::detail::count(
+            XmlStatistics::Counter::ConversionFailures);
+        return ReadStatus(ReadStatus::ConversionFailed, tagName, false);
+    }
+    if (! isValid(static_cast<const T &>(value)))
+        return ReadStatus(ReadStatus::ValidationFailed, tagName, false);
+    destination = std::move(value);
+    return ReadStatus();
+}
+
+} // END namespace detail
+
+
+template <typename T, class TElement>
+ReadStatus tryCopyUniqueChildsTextTo(
+    const TElement & e, const QString & tagName, T & destination) noexcept
+{
+    auto isValid = [](const T &) { return true; };
+    return detail::tryCopyConvertedText(e, tagName, destination, isValid);
+}
+
+template <typename T, typename Predicate, class TElement>
+ReadStatus tryCopyUniqueChildsTextTo(
+    const TElement & e, const QString & tagName, T & destination,
+    Predicate isValid) noexcept
+{
+    return detail::tryCopyConvertedText(e, tagName, destination, isValid);
+}
+
+template <typename T, class TElement>
+ReadStatus tryCopyUniqueChildsTextToMin(
+    const TElement & e, const QString & tagName, T & destination,
+    const T & minValue) noexcept
+{
+    auto isValid = [&minValue](const T & value) {
+        return ! (value < minValue);
+    };
+    return detail::tryCopyConvertedText(e, tagName, destination, isValid);
+}
+
+template <typename T, class TElement>
+ReadStatus tryCopyUniqueChildsTextToMax(
+    const TElement & e, const QString & tagName, T & destination,
+    const T & maxValue) noexcept
+{
+    auto isValid = [&maxValue](const T & value) {
+        return ! (maxValue < value);
+    };
+    return detail::tryCopyConvertedText(e, tagName, destination, isValid);
+}
+
+template <typename T, class TElement>
+ReadStatus tryCopyUniqueChildsTextToRange(
+    const TElement & e, const QString & tagName, T & destination,
+    const T & minValue, const T & maxValue) noexcept
+{
+    auto isValid = [&minValue, &maxValue](const T & value) {
+        return ! (value < minValue) && ! (maxValue < value);
+    };
+    return detail::tryCopyConvertedText(e, tagName, destination, isValid);
+}
+
+template <typename T, class TElement>
+ReadStatus tryCopyUniqueChildsTextToRange0Allowed(
+    const TElement & e, const QString & tagName, T & destination,
+    const T & minValue, const T & maxValue) noexcept
+{
+    auto isValid = [&minValue, &maxValue](const T & value) {
+        return value == T(0) ||
+               (! (value < minValue) && ! (maxValue < value));
+    };
+    return detail::tryCopyConvertedText(e, tagName, destination, isValid);
+}
+
+template <typename T, class TElement>
+ReadStatus tryCopyElementsAttributeTo(
+    const TElement & e, const QString & attributeName,
+    T & destination) noexcept
+{
+    static_assert(IsElement<TElement>::value,
+                  "TElement is not supported by XmlReading shortcuts.");
+    QString value;
+    if (! copyElementsAttributeTo(e, attributeName, value))
+        return ReadStatus(ReadStatus::Absent, attributeName, true);
+    T converted;
+    if (! detail::tryConvert(value, converted)) {
+        XmlStatistics::detail::count(
+            XmlStatistics::Counter::ConversionFailures);
+        return ReadStatus(ReadStatus::ConversionFailed, attributeName, true);
+    }
+    destination = std::move(converted);
+    return ReadStatus();
+}
+
+} // END namespace XmlReading
+} // END namespace QtUtilities
+
+# endif // QT_XML_UTILITIES_READ_RESULT_INL_HPP
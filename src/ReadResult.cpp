@@ -0,0 +1,83 @@
+/*
+ This file is part of vedgTools/QtXmlUtilities.
+ Copyright (C) 2014, 2015 Igor Kushnir <igorkuo AT Google mail>
+
+ vedgTools/QtXmlUtilities is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ vedgTools/QtXmlUtilities is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ vedgTools/QtXmlUtilities.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# include "ReadResult.hpp"
+
+# include <QString>
+# include <QObject>
+# include <QDomElement>
+
+
+namespace QtUtilities
+{
+namespace XmlReading
+{
+QString ReadStatus::message() const
+{
+    switch (code_) {
+        case Ok:
+        case Absent:
+            break;
+        case NotUnique:
+            return QObject::tr("element %1 is not unique.").arg(name_);
+        case ConversionFailed:
+            return isAttribute_ ?
+                   QObject::tr("parsing %1 attribute failed - "
+                               "invalid value.").arg(name_) :
+                   QObject::tr("parsing %1 element failed - "
+                               "invalid value.").arg(name_);
+        case ValidationFailed:
+            return QObject::tr("validating %1 failed - "
+                               "value is invalid.").arg(name_);
+    }
+    return QString();
+}
+
+void ReadStatus::throwIfError() const
+{
+    if (isError())
+        throw ReadError(message());
+}
+
+
+ReadStatus tryGetUniqueChild(const QDomElement & e, const QString & tagName,
+                             QDomElement & destination) noexcept
+{
+    detail::LookupScan scan;
+    const QDomElement child = scan.first(e, tagName);
+    if (child.isNull())
+        return ReadStatus(ReadStatus::Absent, tagName, false);
+    if (! scan.next(child, tagName).isNull())
+        return ReadStatus(ReadStatus::NotUnique, tagName, false);
+    destination = child;
+    return ReadStatus();
+}
+
+ReadStatus tryCopyUniqueChildsTextTo(
+    const QDomElement & e, const QString & tagName,
+    QString & destination) noexcept
+{
+    QDomElement child;
+    const ReadStatus status = tryGetUniqueChild(e, tagName, child);
+    if (status.ok())
+        destination = child.text();
+    return status;
+}
+
+} // END namespace XmlReading
+} // END namespace QtUtilities
@@ -20,18 +20,19 @@
 # define QT_XML_UTILITIES_READING_SHORTCUTS_INL_HPP
 
 # include <QtXmlUtilities/ReadingShortcuts.hpp>
+# include <QtXmlUtilities/Statistics.hpp>
 
 # include <QtCoreUtilities/Error.hpp>
 # include <QtCoreUtilities/String.hpp>
 # include <QtCoreUtilities/Validation.hpp>
 
-# include <TemplateUtilities/Reserve.hpp>
-
 # include <QString>
+# include <QLatin1String>
 # include <QObject>
 # include <QDomElement>
 
 # include <utility>
+# include <vector>
 # include <functional>
 
 
@@ -39,91 +40,301 @@ namespace QtUtilities
 {
 namespace XmlReading
 {
-template <typename T>
-bool copyElementsAttributeTo(
-    const QDomElement & e, const QString & attributeName, T & destination)
+namespace detail
 {
-    QString value;
-    if (copyElementsAttributeTo(e, attributeName, value)) {
-        try {
-            destination = ConvertQString::to<T>(value);
-        }
-        catch (const StringError & error) {
-            throw ReadError(
-                QObject::tr("parsing %1 attribute failed - ").arg(attributeName)
-                + QString::fromUtf8(error.what()));
-        }
-        return true;
+/// @throw ReadError Always; reports that element with name=tagName is not
+/// unique.
+[[noreturn]] void throwNotUniqueError(const QString & tagName);
+
+/// @brief Same as loadRoot(filename), but parses data that was read from the
+/// file with name=filename. gzip-compressed data is decompressed.
+/// @throw ReadError If data could not be decompressed or parsed.
+QDomElement loadFileRootFromData(const QByteArray & data,
+                                 const QString & filename);
+
+/// @brief Converts value of the attribute with name=attributeName to type T.
+/// @throw ReadError If conversion fails.
+template <typename T, class TString>
+T convertAttribute(const QString & value, const TString & attributeName)
+{
+    try {
+        return ConvertQString::to<T>(value);
+    }
+    catch (const StringError & error) {
+        XmlStatistics::detail::count(
+            XmlStatistics::Counter::ConversionFailures);
+        throw ReadError(
+            QObject::tr("parsing %1 attribute failed - ").arg(attributeName)
+            + QString::fromUtf8(error.what()));
     }
-    return false;
 }
 
-template <typename T>
-bool copyUniqueChildsTextTo(const QDomElement & e, const QString & tagName,
-                            T & destination)
+/// @brief Converts text of the element with name=tagName to type T.
+/// @throw ReadError If conversion fails.
+template <typename T, class TString>
+T convertText(const QString & text, const TString & tagName)
 {
+    try {
+        return ConvertQString::to<T>(text);
+    }
+    catch (const StringError & error) {
+        XmlStatistics::detail::count(
+            XmlStatistics::Counter::ConversionFailures);
+        throw ReadError(
+            QObject::tr("parsing %1 element failed - ").arg(tagName)
+            + QString::fromUtf8(error.what()));
+    }
+}
+
+/// @brief Decodes text of the element with name=tagName into destination.
+/// @throw ReadError If text is not valid in encoding.
+void decodeBinaryText(const QString & text, const QString & tagName,
+                      BinaryEncoding encoding, QByteArray & destination);
+
+/// @brief Calls validator(value).
+/// @throw ReadError If calling validator throws Error.
+template <typename T, typename Validator, class TString>
+void validate(const T & value, const TString & tagName, Validator & validator)
+{
+    try {
+        validator(value);
+    }
+    catch (const Error & error) {
+        throw ReadError(QObject::tr("validating %1 failed - ").arg(tagName)
+                        + QString::fromUtf8(error.what()));
+    }
+}
+
+inline QDomElement firstChildElement(const QDomElement & e,
+                                     const QString & tagName)
+{
+    return e.firstChildElement(tagName);
+}
+/// @brief Same as e.firstChildElement(tagName), but does not convert tagName
+/// to QString.
+inline QDomElement firstChildElement(const QDomElement & e,
+                                     QLatin1String tagName)
+{
+    QDomElement child = e.firstChildElement();
+    while (! child.isNull() && child.tagName() != tagName)
+        child = child.nextSiblingElement();
+    return child;
+}
+
+inline QDomElement nextSiblingElement(const QDomElement & e,
+                                      const QString & tagName)
+{
+    return e.nextSiblingElement(tagName);
+}
+/// @brief Same as e.nextSiblingElement(tagName), but does not convert tagName
+/// to QString.
+inline QDomElement nextSiblingElement(const QDomElement & e,
+                                      QLatin1String tagName)
+{
+    QDomElement sibling = e.nextSiblingElement();
+    while (! sibling.isNull() && sibling.tagName() != tagName)
+        sibling = sibling.nextSiblingElement();
+    return sibling;
+}
+
+/// @brief Generic versions of the above for other element types, e.g.
+/// CompactElement.
+template <class TElement, class TString>
+TElement firstChildElement(const TElement & e, const TString & tagName)
+{
+    return e.firstChildElement(tagName);
+}
+template <class TElement, class TString>
+TElement nextSiblingElement(const TElement & e, const TString & tagName)
+{
+    return e.nextSiblingElement(tagName);
+}
+
+/// @brief Searches children of an element (QDomElement or CompactElement)
+/// like firstChildElement() and nextSiblingElement() above. While statistics
+/// are enabled, it also counts the elements it visits and records the lookup
+/// when destroyed.
+class LookupScan
+{
+public:
+    LookupScan() : enabled_(XmlStatistics::isEnabled()), scanned_(0) {}
+    ~LookupScan() {
+        if (enabled_)
+            XmlStatistics::detail::recordLookup(scanned_);
+    }
+
+    LookupScan(const LookupScan &) = delete;
+    LookupScan & operator=(const LookupScan &) = delete;
+
+    template <class TElement, class TString>
+    TElement first(const TElement & parent, const TString & tagName) {
+        return enabled_ ? find(parent.firstChildElement(), tagName) :
+               firstChildElement(parent, tagName);
+    }
+    template <class TElement, class TString>
+    TElement next(const TElement & e, const TString & tagName) {
+        return enabled_ ? find(e.nextSiblingElement(), tagName) :
+               nextSiblingElement(e, tagName);
+    }
+    /// @brief Counts e, which has been found without a scan (e.g. in an
+    /// index), as a single visited element.
+    /// @return e.
+    template <class TElement>
+    TElement indexed(TElement e) {
+        if (enabled_ && ! e.isNull())
+            ++scanned_;
+        return e;
+    }
+
+private:
+    /// @return candidate or its first next sibling with name=tagName.
+    template <class TElement, class TString>
+    TElement find(TElement candidate, const TString & tagName) {
+        while (! candidate.isNull()) {
+            ++scanned_;
+            if (candidate.tagName() == tagName)
+                break;
+            candidate = candidate.nextSiblingElement();
+        }
+        return candidate;
+    }
+
+    const bool enabled_;
+    qint64 scanned_;
+};
+
+/// @brief Implements copyUniqueChildsTextTo<T> for all tag name types.
+template <typename T, class TElement, class TString>
+bool copyConvertedText(const TElement & e, const TString & tagName,
+                       T & destination)
+{
+    static_assert(IsElement<TElement>::value,
+                  "TElement is not supported by XmlReading shortcuts.");
     QString text;
     if (copyUniqueChildsTextTo(e, tagName, text)) {
-        try {
-            destination = ConvertQString::to<T>(text);
-        }
-        catch (const StringError & error) {
-            throw ReadError(
-                QObject::tr("parsing %1 element failed - ").arg(tagName)
-                + QString::fromUtf8(error.what()));
-        }
+        destination = convertText<T>(text, tagName);
         return true;
     }
     return false;
 }
 
-
-template <class QDomElementCollection>
+template <class QDomElementCollection, class TString>
 QDomElementCollection getChildren(const QDomElement & e,
-                                  const QString & tagName)
+                                  const TString & tagName)
 {
+    LookupScan scan;
     QDomElementCollection children;
-    for (QDomElement child = e.firstChildElement(tagName); ! child.isNull();
-            child = children.back().nextSiblingElement(tagName)) {
+    for (QDomElement child = scan.first(e, tagName); ! child.isNull();
+            child = scan.next(children.back(), tagName)) {
         children.push_back(std::move(child));
     }
     return children;
 }
 
-template <class TCollection, typename ElementToT>
-TCollection getChildren(const QDomElement & e, const QString & tagName,
+template <class TCollection, typename ElementToT, class TString>
+TCollection getChildren(const QDomElement & e, const TString & tagName,
                         ElementToT childToResultValue)
 {
-    auto children = getChildren(e, tagName);
     TCollection converted;
-    TemplateUtilities::reserve(converted,
-                               static_cast<typename TCollection::size_type>(
-                                   children.size()));
-    for (auto & child : children)
+    LookupScan scan;
+    QDomElement child = scan.first(e, tagName);
+    while (! child.isNull()) {
+        QDomElement next = scan.next(child, tagName);
         converted.push_back(childToResultValue(std::move(child)));
+        child = std::move(next);
+    }
     return converted;
 }
 
+} // END namespace detail
+
+
+template <typename T, class TElement>
+bool copyElementsAttributeTo(
+    const TElement & e, const QString & attributeName, T & destination)
+{
+    static_assert(IsElement<TElement>::value,
+                  "TElement is not supported by XmlReading shortcuts.");
+    QString value;
+    if (copyElementsAttributeTo(e, attributeName, value)) {
+        destination = detail::convertAttribute<T>(value, attributeName);
+        return true;
+    }
+    return false;
+}
+
+template <typename T, class TElement>
+bool copyUniqueChildsTextTo(const TElement & e, const QString & tagName,
+                            T & destination)
+{
+    return detail::copyConvertedText(e, tagName, destination);
+}
+
+template <class TElement>
+bool copyUniqueChildsBinaryTo(
+    const TElement & e, const QString & tagName, QByteArray & destination,
+    const BinaryEncoding encoding)
+{
+    static_assert(IsElement<TElement>::value,
+                  "TElement is not supported by XmlReading shortcuts.");
+    QString text;
+    if (! copyUniqueChildsTextTo(e, tagName, text))
+        return false;
+    detail::decodeBinaryText(text, tagName, encoding, destination);
+    return true;
+}
+
+template <typename T>
+bool copyUniqueChildsTextTo(const QDomElement & e, QLatin1String tagName,
+                            T & destination)
+{
+    return detail::copyConvertedText(e, tagName, destination);
+}
+
 
-template <typename T, typename Validator>
-bool copyUniqueChildsTextTo(const QDomElement & e, const QString & tagName,
+template <class QDomElementCollection>
+QDomElementCollection getChildren(const QDomElement & e,
+                                  const QString & tagName)
+{
+    return detail::getChildren<QDomElementCollection>(e, tagName);
+}
+
+template <class QDomElementCollection>
+QDomElementCollection getChildren(const QDomElement & e, QLatin1String tagName)
+{
+    return detail::getChildren<QDomElementCollection>(e, tagName);
+}
+
+template <class TCollection, typename ElementToT>
+TCollection getChildren(const QDomElement & e, const QString & tagName,
+                        ElementToT childToResultValue)
+{
+    return detail::getChildren<TCollection>(e, tagName,
+                                            std::move(childToResultValue));
+}
+
+template <class TCollection, typename ElementToT>
+TCollection getChildren(const QDomElement & e, QLatin1String tagName,
+                        ElementToT childToResultValue)
+{
+    return detail::getChildren<TCollection>(e, tagName,
+                                            std::move(childToResultValue));
+}
+
+
+template <typename T, typename Validator, class TElement, class TString>
+bool copyUniqueChildsTextTo(const TElement & e, const TString & tagName,
                             T & destination, Validator validator)
 {
     if (copyUniqueChildsTextTo(e, tagName, destination)) {
-        try {
-            validator(destination);
-        }
-        catch (const Error & error) {
-            throw ReadError(QObject::tr("validating %1 failed - ").arg(tagName)
-                            + QString::fromUtf8(error.what()));
-        }
+        detail::validate(destination, tagName, validator);
         return true;
     }
     return false;
 }
 
-template <typename T>
-bool copyUniqueChildsTextToMin(const QDomElement & e, const QString & tagName,
+template <typename T, class TElement, class TString>
+bool copyUniqueChildsTextToMin(const TElement & e, const TString & tagName,
                                T & destination, const T & minValue)
 {
     return copyUniqueChildsTextTo(e, tagName, destination,
@@ -132,8 +343,8 @@ bool copyUniqueChildsTextToMin(const QDomElement & e, const QString & tagName,
                                             std::cref(minValue)));
 }
 
-template <typename T>
-bool copyUniqueChildsTextToMax(const QDomElement & e, const QString & tagName,
+template <typename T, class TElement, class TString>
+bool copyUniqueChildsTextToMax(const TElement & e, const TString & tagName,
                                T & destination, const T & maxValue)
 {
     return copyUniqueChildsTextTo(e, tagName, destination,
@@ -142,9 +353,9 @@ bool copyUniqueChildsTextToMax(const QDomElement & e, const QString & tagName,
                                             std::cref(maxValue)));
 }
 
-template <typename T>
+template <typename T, class TElement, class TString>
 bool copyUniqueChildsTextToRange(
-    const QDomElement & e, const QString & tagName,
+    const TElement & e, const TString & tagName,
     T & destination, const T & minValue, const T & maxValue)
 {
     return copyUniqueChildsTextTo(
@@ -153,9 +364,9 @@ bool copyUniqueChildsTextToRange(
                          std::cref(minValue), std::cref(maxValue)));
 }
 
-template <typename T>
+template <typename T, class TElement, class TString>
 bool copyUniqueChildsTextToRange0Allowed(
-    const QDomElement & e, const QString & tagName,
+    const TElement & e, const TString & tagName,
     T & destination, const T & minValue, const T & maxValue)
 {
     return copyUniqueChildsTextTo(
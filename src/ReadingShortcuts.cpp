@@ -18,14 +18,25 @@
 
 # include "ReadingShortcuts.hpp"
 
+# include "GzipDevice.hpp"
+
+# include <QtXmlUtilities/Statistics.hpp>
+
 # include <QtCoreUtilities/String.hpp>
 
+# include <QByteArray>
 # include <QString>
+# include <QLatin1String>
 # include <QStringList>
 # include <QObject>
+# include <QIODevice>
 # include <QFile>
+# include <QBuffer>
 # include <QDomElement>
 # include <QDomDocument>
+# include <QElapsedTimer>
+
+# include <limits>
 
 
 namespace QtUtilities
@@ -34,85 +45,156 @@ namespace XmlReading
 {
 ReadError::~ReadError() noexcept = default;
 
-void assertTagName(const QDomElement & e, const QString & tagName)
+namespace detail
 {
-    if (e.tagName() != tagName) {
+void throwNotUniqueError(const QString & tagName)
+{
+    throw ReadError(QObject::tr("element %1 is not unique.").arg(tagName));
+}
+
+void decodeBinaryText(const QString & text, const QString & tagName,
+                      const BinaryEncoding encoding, QByteArray & destination)
+{
+    if (! decodeBinary(text, encoding, destination)) {
+        XmlStatistics::detail::count(
+            XmlStatistics::Counter::ConversionFailures);
         throw ReadError(
-            QObject::tr(
-                "tag name assertion failed. \"%1\" expected "
-                "but \"%2\" found.").arg(tagName, e.tagName()));
+            QObject::tr("parsing %1 element failed - invalid %2 data.").arg(
+                tagName, QLatin1String(encodingName(encoding))));
     }
 }
 
-QDomElement loadRoot(const QString & filename)
+} // END namespace detail
+
+
+namespace
+{
+/// @param source Is passed to QDomDocument::setContent().
+/// @param sourceName Description of source for error message.
+template <typename Source>
+QDomElement parseRoot(Source source, const QString & sourceName)
 {
     QDomDocument doc;
-    {
-        QFile file(filename);
-        QString errorMsg;
-        int line, column;
-        if (! doc.setContent(& file, & errorMsg, & line, & column)) {
-            throw ReadError(
-                QObject::tr("could not load XML document from file %1."
-                            " On line %2 at column %3: %4.").arg(filename).arg(
-                    line).arg(column).arg(errorMsg));
-        }
+    QString errorMsg;
+    int line, column;
+    if (! doc.setContent(source, & errorMsg, & line, & column)) {
+        throw ReadError(
+            QObject::tr("could not load XML document from %1."
+                        " On line %2 at column %3: %4.").arg(sourceName).arg(
+                line).arg(column).arg(errorMsg));
     }
     return doc.documentElement();
 }
 
-QDomElement loadRoot(const QString & filename, const QString & tagName)
+qint64 sourceSize(const QByteArray & data)
+{
+    return data.size();
+}
+
+qint64 sourceSize(QIODevice * const device)
+{
+    return device->isSequential() ? -1 : device->size();
+}
+
+/// @brief Calls parseRoot(source, sourceName) and records statistics of the
+/// call if they are enabled.
+template <typename Source>
+QDomElement loadRootFrom(Source source, const QString & sourceName)
+{
+    if (! XmlStatistics::isEnabled())
+        return parseRoot(source, sourceName);
+    const qint64 bytes = sourceSize(source);
+    QElapsedTimer timer;
+    timer.start();
+    QDomElement root;
+    try {
+        root = parseRoot(source, sourceName);
+    }
+    catch (...) {
+        XmlStatistics::detail::recordLoad(sourceName, bytes, nullptr,
+                                          timer.nsecsElapsed());
+        throw;
+    }
+    XmlStatistics::detail::recordLoad(sourceName, bytes, & root,
+                                      timer.nsecsElapsed());
+    return root;
+}
+
+QString fileSourceName(const QString & filename)
+{
+    return QObject::tr("file %1").arg(filename);
+}
+
+/// @brief Decompresses device, which must be open and start with gzip magic
+/// bytes, while parsing it. filename is used in error messages.
+QDomElement loadGzippedRoot(QIODevice & device, const QString & filename)
+{
+    GzipDevice gzip(device);
+    if (! gzip.open(QIODevice::ReadOnly)) {
+        throw ReadError(QObject::tr("could not decompress file %1: %2").arg(
+                            filename, gzip.errorString()));
+    }
+    return loadRootFrom(& gzip, fileSourceName(filename));
+}
+
+QDomElement checkedRoot(QDomElement root, const QString & tagName)
 {
-    QDomElement root = loadRoot(filename);
     if (! root.isNull())
         assertTagName(root, tagName);
     return root;
 }
 
 
-QDomElement getUniqueChild(const QDomElement & e, const QString & tagName)
+template <class TString>
+void assertTagNameImpl(const QDomElement & e, const TString & tagName)
 {
-    QDomElement child = e.firstChildElement(tagName);
-    if (! child.nextSiblingElement(tagName).isNull())
-        throw ReadError(QObject::tr("element %1 is not unique.").arg(tagName));
-    return child;
+    if (e.tagName() != tagName) {
+        throw ReadError(
+            QObject::tr(
+                "tag name assertion failed. \"%1\" expected "
+                "but \"%2\" found.").arg(tagName, e.tagName()));
+    }
 }
 
-bool copyElementsAttributeTo(
-    const QDomElement & e, const QString & attributeName, QString & destination)
+template <class TString>
+QDomElement getUniqueChildImpl(const QDomElement & e, const TString & tagName)
 {
-    if (! e.hasAttribute(attributeName))
-        return false;
-    destination = e.attribute(attributeName);
-    return true;
+    detail::LookupScan scan;
+    QDomElement child = scan.first(e, tagName);
+    if (! scan.next(child, tagName).isNull())
+        detail::throwNotUniqueError(tagName);
+    return child;
 }
 
-bool copyUniqueChildsTextTo(const QDomElement & e, const QString & tagName,
-                            QString & destination)
+template <class TString>
+bool copyUniqueChildsTextToImpl(const QDomElement & e, const TString & tagName,
+                                QString & destination)
 {
-    const QDomElement child = getUniqueChild(e, tagName);
+    const QDomElement child = getUniqueChildImpl(e, tagName);
     if (child.isNull())
         return false;
     destination = child.text();
     return true;
 }
 
-bool copyUniqueChildsTextToByteArray(
-    const QDomElement & e, const QString & tagName, QByteArray & destination)
+template <class TString>
+bool copyUniqueChildsTextToByteArrayImpl(
+    const QDomElement & e, const TString & tagName, QByteArray & destination)
 {
     QString text;
-    if (copyUniqueChildsTextTo(e, tagName, text)) {
+    if (copyUniqueChildsTextToImpl(e, tagName, text)) {
         destination = qStringToByteArray(text);
         return true;
     }
     return false;
 }
 
-bool copyUniqueChildsStringListTo(
-    const QDomElement & e, const QString & listTagName,
-    const QString & stringTagName, QStringList & destination)
+template <class TString>
+bool copyUniqueChildsStringListToImpl(
+    const QDomElement & e, const TString & listTagName,
+    const TString & stringTagName, QStringList & destination)
 {
-    const QDomElement listElement = getUniqueChild(e, listTagName);
+    const QDomElement listElement = getUniqueChildImpl(e, listTagName);
     if (listElement.isNull())
         return false;
     destination = getChildren<QStringList>(listElement, stringTagName,
@@ -122,5 +204,157 @@ bool copyUniqueChildsStringListTo(
     return true;
 }
 
+} // END unnamed namespace
+
+
+void assertTagName(const QDomElement & e, const QString & tagName)
+{
+    assertTagNameImpl(e, tagName);
+}
+
+
+QDomElement loadRoot(const QString & filename)
+{
+    QFile file(filename);
+    // If the file can not be opened, QDomDocument reports the error.
+    if (file.open(QIODevice::ReadOnly) && GzipDevice::isGzipped(file))
+        return loadGzippedRoot(file, filename);
+    return loadRootFrom(& file, fileSourceName(filename));
+}
+
+QDomElement loadRoot(const QString & filename, const QString & tagName)
+{
+    return checkedRoot(loadRoot(filename), tagName);
+}
+
+QDomElement loadRoot(QIODevice & device)
+{
+    return loadRootFrom(& device, QObject::tr("device"));
+}
+
+QDomElement loadRoot(QIODevice & device, const QString & tagName)
+{
+    return checkedRoot(loadRoot(device), tagName);
+}
+
+QDomElement loadRootFromData(const QByteArray & data)
+{
+    return loadRootFrom(data, QObject::tr("data"));
+}
+
+QDomElement loadRootFromData(const QByteArray & data, const QString & tagName)
+{
+    return checkedRoot(loadRootFromData(data), tagName);
+}
+
+namespace detail
+{
+QDomElement loadFileRootFromData(const QByteArray & data,
+                                 const QString & filename)
+{
+    QBuffer buffer;
+    buffer.setData(data);
+    if (buffer.open(QIODevice::ReadOnly) && GzipDevice::isGzipped(buffer))
+        return loadGzippedRoot(buffer, filename);
+    return loadRootFrom(data, fileSourceName(filename));
+}
+
+} // END namespace detail
+
+QDomElement loadRootMapped(const QString & filename)
+{
+    QFile file(filename);
+    if (! file.open(QIODevice::ReadOnly)) {
+        throw ReadError(
+            QObject::tr("could not open file %1 for reading.").arg(filename));
+    }
+    if (GzipDevice::isGzipped(file))
+        return loadGzippedRoot(file, filename);
+    const qint64 size = file.size();
+    uchar * const mapped =
+        size > 0 && size <= std::numeric_limits<int>::max() ?
+        file.map(0, size) : nullptr;
+    if (mapped == nullptr)
+        return loadRootFrom(& file, fileSourceName(filename));
+    // QDomDocument does not reference data after parsing, so the file may be
+    // unmapped (by its destructor) right after this call.
+    return loadRootFrom(
+               QByteArray::fromRawData(reinterpret_cast<const char *>(mapped),
+                                       static_cast<int>(size)),
+               fileSourceName(filename));
+}
+
+QDomElement loadRootMapped(const QString & filename, const QString & tagName)
+{
+    return checkedRoot(loadRootMapped(filename), tagName);
+}
+
+
+QDomElement getUniqueChild(const QDomElement & e, const QString & tagName)
+{
+    return getUniqueChildImpl(e, tagName);
+}
+
+bool copyElementsAttributeTo(
+    const QDomElement & e, const QString & attributeName, QString & destination)
+{
+    if (! e.hasAttribute(attributeName))
+        return false;
+    destination = e.attribute(attributeName);
+    return true;
+}
+
+bool copyUniqueChildsTextTo(const QDomElement & e, const QString & tagName,
+                            QString & destination)
+{
+    return copyUniqueChildsTextToImpl(e, tagName, destination);
+}
+
+bool copyUniqueChildsTextToByteArray(
+    const QDomElement & e, const QString & tagName, QByteArray & destination)
+{
+    return copyUniqueChildsTextToByteArrayImpl(e, tagName, destination);
+}
+
+bool copyUniqueChildsStringListTo(
+    const QDomElement & e, const QString & listTagName,
+    const QString & stringTagName, QStringList & destination)
+{
+    return copyUniqueChildsStringListToImpl(e, listTagName, stringTagName,
+                                            destination);
+}
+
+
+void assertTagName(const QDomElement & e, const QLatin1String tagName)
+{
+    assertTagNameImpl(e, tagName);
+}
+
+QDomElement getUniqueChild(const QDomElement & e, const QLatin1String tagName)
+{
+    return getUniqueChildImpl(e, tagName);
+}
+
+bool copyUniqueChildsTextTo(const QDomElement & e, const QLatin1String tagName,
+                            QString & destination)
+{
+    return copyUniqueChildsTextToImpl(e, tagName, destination);
+}
+
+bool copyUniqueChildsTextToByteArray(
+    const QDomElement & e, const QLatin1String tagName,
+    QByteArray & destination)
+{
+    return copyUniqueChildsTextToByteArrayImpl(e, tagName, destination);
+}
+
+bool copyUniqueChildsStringListTo(
+    const QDomElement & e, const QLatin1String listTagName,
+    const QLatin1String stringTagName, QStringList & destination)
+{
+    return copyUniqueChildsStringListToImpl(e, listTagName, stringTagName,
+                                            destination);
+}
+
 } // END namespace XmlReading
 } // END namespace QtUtilities
@@ -0,0 +1,120 @@
+/*
+ This file is part of vedgTools/QtXmlUtilities.
+ Copyright (C) 2014, 2015 Igor Kushnir <igorkuo AT Google mail>
+
+ vedgTools/QtXmlUtilities is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ vedgTools/QtXmlUtilities is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ vedgTools/QtXmlUtilities.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# include "RecordReader.hpp"
+
+# include "DomBuilder.hpp"
+# include "LimitChecker.hpp"
+
+# include <QByteArray>
+# include <QString>
+# include <QObject>
+# include <QIODevice>
+# include <QXmlStreamReader>
+# include <QDomElement>
+
+# include <utility>
+
+
+namespace QtUtilities
+{
+namespace XmlReading
+{
+RecordReader::RecordReader(const QString & recordTagName, Handler handler)
+    : recordTagName_(recordTagName), handler_(std::move(handler)),
+      builder_(new detail::DomBuilder), bytesAdded_(0), inRecord_(false),
+      recordCount_(0)
+{
+    xml_.setNamespaceProcessing(false);
+}
+
+RecordReader::~RecordReader() = default;
+
+void RecordReader::setLimits(const Limits & limits)
+{
+    limits_.reset(limits.isUnlimited() ? nullptr :
+                  new detail::LimitChecker(limits));
+}
+
+void RecordReader::addData(const QByteArray & data)
+{
+    bytesAdded_ += data.size();
+    if (limits_ != nullptr)
+        limits_->checkInputBytes(bytesAdded_);
+    xml_.addData(data);
+    parseAvailable();
+}
+
+void RecordReader::finish()
+{
+    if (xml_.tokenType() != QXmlStreamReader::EndDocument)
+        throwError();
+}
+
+void RecordReader::readAll(QIODevice & device, const qint64 chunkSize)
+{
+    while (! device.atEnd()) {
+        const QByteArray chunk = device.read(chunkSize);
+        if (chunk.isEmpty())
+            break;
+        addData(chunk);
+    }
+    finish();
+}
+
+void RecordReader::parseAvailable()
+{
+    while (xml_.tokenType() != QXmlStreamReader::EndDocument) {
+        const QXmlStreamReader::TokenType token = xml_.readNext();
+        if (token == QXmlStreamReader::Invalid) {
+            if (xml_.error() == QXmlStreamReader::PrematureEndOfDocumentError)
+                return; // Wait for more data.
+            throwError();
+        }
+        if (limits_ != nullptr)
+            limits_->check(xml_);
+        if (! inRecord_) {
+            if (token != QXmlStreamReader::StartElement ||
+                    xml_.qualifiedName() != recordTagName_) {
+                continue;
+            }
+            inRecord_ = true;
+        }
+        if (builder_->process(xml_)) {
+            inRecord_ = false;
+            ++recordCount_;
+            const QDomElement record = builder_->root();
+            builder_->reset();
+            handler_(record);
+        }
+    }
+}
+
+void RecordReader::throwError() const
+{
+    const QString errorMsg = xml_.hasError() ? xml_.errorString() :
+                             QObject::tr("unexpected end of document");
+    throw ReadError(
+        QObject::tr("could not load XML document from %1."
+                    " On line %2 at column %3: %4.").arg(
+            QObject::tr("data stream")).arg(xml_.lineNumber()).arg(
+            xml_.columnNumber()).arg(errorMsg));
+}
+
+} // END namespace XmlReading
+} // END namespace QtUtilities
@@ -0,0 +1,173 @@
+/*
+ This file is part of vedgTools/QtXmlUtilities.
+ Copyright (C) 2014, 2015 Igor Kushnir <igorkuo AT Google mail>
+
+ vedgTools/QtXmlUtilities is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ vedgTools/QtXmlUtilities is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ vedgTools/QtXmlUtilities.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# include "Statistics.hpp"
+
+# include <QString>
+# include <QMutex>
+# include <QMutexLocker>
+# include <QDomElement>
+
+# include <memory>
+# include <utility>
+
+
+namespace QtUtilities
+{
+namespace XmlStatistics
+{
+namespace detail
+{
+std::atomic<bool> enabled(false);
+std::atomic<qint64> counters[counterCount] {};
+
+} // END namespace detail
+
+
+namespace
+{
+QMutex observerMutex;
+std::shared_ptr<const Observer> currentObserver;
+
+void notify(const Event & event)
+{
+    std::shared_ptr<const Observer> observer;
+    {
+        QMutexLocker lock(& observerMutex);
+        observer = currentObserver;
+    }
+    if (observer != nullptr)
+        (*observer)(event);
+}
+
+qint64 countElements(const QDomElement & root)
+{
+    qint64 count = 0;
+    QDomElement e = root;
+    while (! e.isNull()) {
+        ++count;
+        QDomElement next = e.firstChildElement();
+        while (next.isNull() && e != root) {
+            next = e.nextSiblingElement();
+            if (next.isNull())
+                e = e.parentNode().toElement();
+        }
+        if (next.isNull())
+            break;
+        e = std::move(next);
+    }
+    return count;
+}
+
+} // END unnamed namespace
+
+
+namespace detail
+{
+void recordLoad(const QString & source, const qint64 bytes,
+                const QDomElement * const root, const qint64 nanoseconds)
+{
+    const qint64 elements = root == nullptr ? -1 : countElements(*root);
+    add(Counter::LoadCalls);
+    add(Counter::LoadNanoseconds, nanoseconds);
+    if (root == nullptr)
+        add(Counter::LoadFailures);
+    else
+        add(Counter::LoadElements, elements);
+    if (bytes > 0)
+        add(Counter::LoadBytes, bytes);
+    notify(Event { Event::Load, source, bytes, elements, nanoseconds,
+                   root != nullptr });
+}
+
+void recordSave(const QString & source, const qint64 bytes,
+                const bool succeeded, const qint64 nanoseconds)
+{
+    add(Counter::SaveCalls);
+    add(Counter::SaveNanoseconds, nanoseconds);
+    if (succeeded)
+        add(Counter::SaveBytes, bytes);
+    else
+        add(Counter::SaveFailures);
+    notify(Event { Event::Save, source, bytes, -1, nanoseconds, succeeded });
+}
+
+} // END namespace detail
+
+
+const char * name(const Counter counter)
+{
+    switch (counter) {
+        case Counter::LoadCalls:
+            return "loadCalls";
+        case Counter::LoadFailures:
+            return "loadFailures";
+        case Counter::LoadBytes:
+            return "loadBytes";
+        case Counter::LoadElements:
+            return "loadElements";
+        case Counter::LoadNanoseconds:
+            return "loadNanoseconds";
+        case Counter::SaveCalls:
+            return "saveCalls";
+        case Counter::SaveFailures:
+            return "saveFailures";
+        case Counter::SaveBytes:
+            return "saveBytes";
+        case Counter::SaveNanoseconds:
+            return "saveNanoseconds";
+        case Counter::ChildLookups:
+            return "childLookups";
+        case Counter::ScannedSiblings:
+            return "scannedSiblings";
+        case Counter::ConversionFailures:
+            return "conversionFailures";
+    }
+    return "unknown";
+}
+
+void setEnabled(const bool enable)
+{
+    detail::enabled.store(enable, std::memory_order_relaxed);
+}
+
+Snapshot snapshot()
+{
+    Snapshot result;
+    for (int i = 0; i < counterCount; ++i)
+        result.values[i] = detail::counters[i].load(std::memory_order_relaxed);
+    return result;
+}
+
+void reset()
+{
+    for (std::atomic<qint64> & counter : detail::counters)
+        counter.store(0, std::memory_order_relaxed);
+}
+
+void setObserver(Observer observer)
+{
+    std::shared_ptr<const Observer> newObserver;
+    if (observer)
+        newObserver = std::make_shared<const Observer>(std::move(observer));
+    QMutexLocker lock(& observerMutex);
+    currentObserver.swap(newObserver);
+}
+
+} // END namespace XmlStatistics
+} // END namespace QtUtilities
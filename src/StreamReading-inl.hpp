@@ -0,0 +1,146 @@
+/*
+ This file is part of vedgTools/QtXmlUtilities.
+ Copyright (C) 2014, 2015 Igor Kushnir <igorkuo AT Google mail>
+
+ vedgTools/QtXmlUtilities is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ vedgTools/QtXmlUtilities is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ vedgTools/QtXmlUtilities.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# ifndef QT_XML_UTILITIES_STREAM_READING_INL_HPP
+# define QT_XML_UTILITIES_STREAM_READING_INL_HPP
+
+# include <QtXmlUtilities/StreamReading.hpp>
+
+# include <QtXmlUtilities/ReadingShortcuts.hpp>
+
+# include <QtCoreUtilities/Validation.hpp>
+
+# include <QString>
+
+# include <utility>
+# include <functional>
+
+
+namespace QtUtilities
+{
+namespace XmlReading
+{
+template <typename T>
+bool StreamReader::copyElementsAttributeTo(const QString & attributeName,
+        T & destination) const
+{
+    QString value;
+    if (copyElementsAttributeTo(attributeName, value)) {
+        destination = detail::convertAttribute<T>(value, attributeName);
+        return true;
+    }
+    return false;
+}
+
+template <typename ChildHandler>
+void StreamReader::readChildren(ChildHandler handler)
+{
+    while (readNextChild()) {
+        handler(*this);
+        // The child was not read by handler.
+        if (xml_.isStartElement())
+            skipElement();
+    }
+}
+
+
+template <typename T>
+void ChildrenReader::copyUniqueChildsTextTo(const QString & tagName,
+        T & destination)
+{
+    addUniqueText(tagName,
+    [tagName, &destination](const QString & text) -> Assignment {
+        const T value = detail::convertText<T>(text, tagName);
+        return [&destination, value] { destination = value; };
+    });
+}
+
+template <typename T, typename Validator>
+void ChildrenReader::copyUniqueChildsTextTo(
+    const QString & tagName, T & destination, Validator validator)
+{
+    addUniqueText(tagName,
+    [tagName, &destination, validator](const QString & text) mutable
+    -> Assignment {
+        const T value = detail::convertText<T>(text, tagName);
+        detail::validate(value, tagName, validator);
+        return [&destination, value] { destination = value; };
+    });
+}
+
+template <typename T>
+void ChildrenReader::copyUniqueChildsTextToMin(
+    const QString & tagName, T & destination, T minValue)
+{
+    copyUniqueChildsTextTo(tagName, destination,
+                           std::bind(checkMinValue<T>, std::placeholders::_1,
+                                     std::move(minValue)));
+}
+
+template <typename T>
+void ChildrenReader::copyUniqueChildsTextToMax(
+    const QString & tagName, T & destination, T maxValue)
+{
+    copyUniqueChildsTextTo(tagName, destination,
+                           std::bind(checkMaxValue<T>, std::placeholders::_1,
+                                     std::move(maxValue)));
+}
+
+template <typename T>
+void ChildrenReader::copyUniqueChildsTextToRange(
+    const QString & tagName, T & destination, T minValue, T maxValue)
+{
+    copyUniqueChildsTextTo(tagName, destination,
+                           std::bind(checkRange<T>, std::placeholders::_1,
+                                     std::move(minValue), std::move(maxValue)));
+}
+
+template <typename T>
+void ChildrenReader::copyUniqueChildsTextToRange0Allowed(
+    const QString & tagName, T & destination, T minValue, T maxValue)
+{
+    copyUniqueChildsTextTo(tagName, destination,
+                           std::bind(checkRange0Allowed<T>,
+                                     std::placeholders::_1,
+                                     std::move(minValue), std::move(maxValue)));
+}
+
+template <typename ChildHandler>
+void ChildrenReader::getUniqueChild(const QString & tagName,
+                                    ChildHandler handler)
+{
+    add(Entry { tagName, true, 0, QString(), QStringList(),
+    [handler](StreamReader & reader, Entry &) mutable {
+        handler(reader);
+    }, nullptr });
+}
+
+template <typename ChildHandler>
+void ChildrenReader::getChildren(const QString & tagName,
+                                 ChildHandler handler)
+{
+    add(Entry { tagName, false, 0, QString(), QStringList(),
+    [handler](StreamReader & reader, Entry &) mutable {
+        handler(reader);
+    }, nullptr });
+}
+
+} // END namespace XmlReading
+} // END namespace QtUtilities
+
+# endif // QT_XML_UTILITIES_STREAM_READING_INL_HPP
@@ -0,0 +1,363 @@
+/*
+ This file is part of vedgTools/QtXmlUtilities.
+ Copyright (C) 2014, 2015 Igor Kushnir <igorkuo AT Google mail>
+
+ vedgTools/QtXmlUtilities is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ vedgTools/QtXmlUtilities is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ vedgTools/QtXmlUtilities.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# include "StreamReading.hpp"
+
+# include "LimitChecker.hpp"
+
+# include <QtXmlUtilities/Statistics.hpp>
+
+# include <QtCoreUtilities/String.hpp>
+
+# include <QByteArray>
+# include <QString>
+# include <QLatin1String>
+# include <QStringList>
+# include <QHash>
+# include <QObject>
+# include <QIODevice>
+# include <QFile>
+# include <QXmlStreamReader>
+
+# include <memory>
+# include <utility>
+# include <vector>
+
+
+namespace QtUtilities
+{
+namespace XmlReading
+{
+StreamReader::StreamReader(QIODevice & device) : xml_(& device)
+{
+}
+
+StreamReader::StreamReader(const QString & filename)
+    : file_(new QFile(filename)), filename_(filename)
+{
+    if (! file_->open(QIODevice::ReadOnly)) {
+        throw ReadError(
+            QObject::tr("could not open file %1 for reading.").arg(filename));
+    }
+    xml_.setDevice(file_.get());
+}
+
+StreamReader::~StreamReader() = default;
+
+void StreamReader::setLimits(const Limits & limits)
+{
+    limits_.reset(limits.isUnlimited() ? nullptr :
+                  new detail::LimitChecker(limits));
+    const QIODevice * const device = xml_.device();
+    if (limits_ != nullptr && device != nullptr && ! device->isSequential())
+        limits_->checkInputBytes(device->size() - device->pos());
+}
+
+void StreamReader::readRoot()
+{
+    while (! xml_.atEnd()) {
+        if (readNextToken() == QXmlStreamReader::StartElement)
+            return;
+    }
+    throwError();
+}
+
+void StreamReader::readRoot(const QString & tagName)
+{
+    readRoot();
+    assertTagName(tagName);
+}
+
+void StreamReader::assertTagName(const QString & tagName) const
+{
+    if (! hasTagName(tagName)) {
+        throw ReadError(
+            QObject::tr(
+                "tag name assertion failed. \"%1\" expected "
+                "but \"%2\" found.").arg(tagName, this->tagName()));
+    }
+}
+
+bool StreamReader::copyElementsAttributeTo(const QString & attributeName,
+        QString & destination) const
+{
+    const QXmlStreamAttributes attributes = xml_.attributes();
+    if (! attributes.hasAttribute(attributeName))
+        return false;
+    destination = attributes.value(attributeName).toString();
+    return true;
+}
+
+QString StreamReader::readText()
+{
+    if (limits_ != nullptr)
+        return readTextChecked();
+    QString text =
+        xml_.readElementText(QXmlStreamReader::IncludeChildElements);
+    checkError();
+    return text;
+}
+
+QByteArray StreamReader::readBinary(const BinaryEncoding encoding)
+{
+    const QString tagName = this->tagName();
+    BinaryDecoder decoder(encoding);
+    bool valid = true;
+    for (int depth = 1; depth != 0; ) {
+        switch (readNextToken()) {
+            case QXmlStreamReader::StartElement:
+                ++depth;
+                break;
+            case QXmlStreamReader::EndElement:
+                --depth;
+                break;
+            case QXmlStreamReader::Characters:
+                if (valid) {
+                    const auto text = xml_.text();
+                    valid = decoder.add(text.constData(), text.size());
+                }
+                break;
+            case QXmlStreamReader::Invalid:
+            case QXmlStreamReader::EndDocument:
+                throwError();
+            default:
+                break;
+        }
+    }
+    if (! valid || ! decoder.finish()) {
+        XmlStatistics::detail::count(
+            XmlStatistics::Counter::ConversionFailures);
+        throw ReadError(
+            QObject::tr("parsing %1 element failed - invalid %2 data.").arg(
+                tagName, QLatin1String(encodingName(encoding))));
+    }
+    return decoder.takeResult();
+}
+
+void StreamReader::skipElement()
+{
+    if (limits_ != nullptr)
+        return skipElementChecked();
+    xml_.skipCurrentElement();
+    checkError();
+}
+
+bool StreamReader::readNextChild()
+{
+    while (! xml_.atEnd()) {
+        switch (readNextToken()) {
+            case QXmlStreamReader::StartElement:
+                return true;
+            case QXmlStreamReader::EndElement:
+                return false;
+            default:
+                break;
+        }
+    }
+    throwError();
+}
+
+QXmlStreamReader::TokenType StreamReader::readNextToken()
+{
+    const QXmlStreamReader::TokenType token = xml_.readNext();
+    if (limits_ != nullptr && token != QXmlStreamReader::Invalid) {
+        limits_->check(xml_);
+        if (limits_->limits().maxInputBytes != 0) {
+            const QIODevice * const device = xml_.device();
+            limits_->checkInputBytes(
+                device != nullptr && ! device->isSequential() ?
+                device->pos() : xml_.characterOffset());
+        }
+    }
+    return token;
+}
+
+QString StreamReader::readTextChecked()
+{
+    QString text;
+    for (int depth = 1; depth != 0; ) {
+        switch (readNextToken()) {
+            case QXmlStreamReader::StartElement:
+                ++depth;
+                break;
+            case QXmlStreamReader::EndElement:
+                --depth;
+                break;
+            case QXmlStreamReader::Characters:
+            case QXmlStreamReader::EntityReference:
+                text += xml_.text();
+                break;
+            case QXmlStreamReader::Invalid:
+            case QXmlStreamReader::EndDocument:
+                throwError();
+            default:
+                break;
+        }
+    }
+    return text;
+}
+
+void StreamReader::skipElementChecked()
+{
+    for (int depth = 1; depth != 0; ) {
+        switch (readNextToken()) {
+            case QXmlStreamReader::StartElement:
+                ++depth;
+                break;
+            case QXmlStreamReader::EndElement:
+                --depth;
+                break;
+            case QXmlStreamReader::Invalid:
+            case QXmlStreamReader::EndDocument:
+                throwError();
+            default:
+                break;
+        }
+    }
+}
+
+void StreamReader::checkError() const
+{
+    if (xml_.hasError())
+        throwError();
+}
+
+void StreamReader::throwError() const
+{
+    const QString errorMsg = xml_.hasError() ? xml_.errorString() :
+                             QObject::tr("unexpected end of document");
+    const QString source = filename_.isEmpty() ?
+                           QObject::tr("device") :
+                           QObject::tr("file %1").arg(filename_);
+    throw ReadError(
+        QObject::tr("could not load XML document from %1."
+                    " On line %2 at column %3: %4.").arg(source).arg(
+            xml_.lineNumber()).arg(xml_.columnNumber()).arg(errorMsg));
+}
+
+
+void ChildrenReader::copyUniqueChildsTextTo(const QString & tagName,
+        QString & destination)
+{
+    addUniqueText(tagName, [&destination](const QString & text) -> Assignment {
+        return [&destination, text] { destination = text; };
+    });
+}
+
+void ChildrenReader::copyUniqueChildsTextToByteArray(
+    const QString & tagName, QByteArray & destination)
+{
+    addUniqueText(tagName, [&destination](const QString & text) -> Assignment {
+        const QByteArray value = qStringToByteArray(text);
+        return [&destination, value] { destination = value; };
+    });
+}
+
+void ChildrenReader::copyUniqueChildsBinaryTo(
+    const QString & tagName, QByteArray & destination,
+    const BinaryEncoding encoding)
+{
+    const auto data = std::make_shared<QByteArray>();
+    add(Entry { tagName, true, 0, QString(), QStringList(),
+    [data, encoding](StreamReader & reader, Entry &) {
+        *data = reader.readBinary(encoding);
+    },
+    [data, &destination](const Entry &) -> Assignment {
+        return [data, &destination] { destination.swap(*data); };
+    } });
+}
+
+void ChildrenReader::copyUniqueChildsStringListTo(
+    const QString & listTagName, const QString & stringTagName,
+    QStringList & destination)
+{
+    add(Entry { listTagName, true, 0, QString(), QStringList(),
+    [stringTagName](StreamReader & reader, Entry & entry) {
+        reader.readChildren([&](StreamReader & child) {
+            if (child.hasTagName(stringTagName))
+                entry.strings << child.readText();
+        });
+    },
+    [&destination](const Entry & entry) -> Assignment {
+        const QStringList strings = entry.strings;
+        return [&destination, strings] { destination = strings; };
+    } });
+}
+
+void ChildrenReader::read(StreamReader & reader)
+{
+    for (Entry & entry : entries_) {
+        entry.count = 0;
+        entry.text.clear();
+        entry.strings.clear();
+    }
+    reader.readChildren([this](StreamReader & child) {
+        Entry * const entry = find(child);
+        if (entry == nullptr)
+            return;
+        if (entry->unique && entry->count != 0)
+            detail::throwNotUniqueError(entry->tagName);
+        ++entry->count;
+        entry->readChild(child, *entry);
+    });
+    std::vector<Assignment> assignments;
+    for (const Entry & entry : entries_) {
+        if (entry.count != 0 && entry.prepare)
+            assignments.push_back(entry.prepare(entry));
+    }
+    for (const Assignment & assign : assignments)
+        assign();
+}
+
+bool ChildrenReader::hasChild(const QString & tagName) const
+{
+    const int index = indices_.value(tagName, -1);
+    return index != -1 && entries_[std::size_t(index)].count != 0;
+}
+
+void ChildrenReader::addUniqueText(
+    const QString & tagName,
+    std::function<Assignment (const QString &)> prepare)
+{
+    add(Entry { tagName, true, 0, QString(), QStringList(),
+    [](StreamReader & reader, Entry & entry) {
+        entry.text = reader.readText();
+    },
+    [prepare](const Entry & entry) {
+        return prepare(entry.text);
+    } });
+}
+
+void ChildrenReader::add(Entry entry)
+{
+    if (indices_.contains(entry.tagName)) {
+        throw Error(QObject::tr("child %1 is registered more than once.").arg(
+                        entry.tagName));
+    }
+    indices_.insert(entry.tagName, int(entries_.size()));
+    entries_.push_back(std::move(entry));
+}
+
+ChildrenReader::Entry * ChildrenReader::find(const StreamReader & reader)
+{
+    const int index = indices_.value(reader.tagName(), -1);
+    return index == -1 ? nullptr : & entries_[std::size_t(index)];
+}
+
+} // END namespace XmlReading
+} // END namespace QtUtilities
@@ -0,0 +1,224 @@
+/*
+ This file is part of vedgTools/QtXmlUtilities.
+ Copyright (C) 2014, 2015 Igor Kushnir <igorkuo AT Google mail>
+
+ vedgTools/QtXmlUtilities is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ vedgTools/QtXmlUtilities is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ vedgTools/QtXmlUtilities.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# include "StreamWriting.hpp"
+
+# include <QtCoreUtilities/Miscellaneous.hpp>
+
+# include <QByteArray>
+# include <QString>
+# include <QStringList>
+# include <QObject>
+# include <QFile>
+# include <QXmlStreamWriter>
+
+# if QT_VERSION >= QT_VERSION_CHECK(5, 1, 0)
+# include <QSaveFile>
+# endif
+
+# include <algorithm>
+
+
+namespace QtUtilities
+{
+namespace XmlWriting
+{
+StreamElement::StreamElement(StreamElement && other)
+    : document_(other.document_), id_(other.id_), depth_(other.depth_)
+{
+    other.document_ = nullptr;
+}
+
+StreamElement::~StreamElement()
+{
+    close();
+}
+
+StreamElement StreamElement::appendElement(const QString & tagName)
+{
+    prepareForAppending().writeStartElement(tagName);
+    return StreamElement(*document_);
+}
+
+void StreamElement::appendChild(const QString & tagName, const QString & text)
+{
+    prepareForAppending().writeTextElement(tagName, text);
+}
+
+void StreamElement::appendChildBinary(const QString & tagName,
+                                      const QByteArray & data,
+                                      const BinaryEncoding encoding)
+{
+    // A multiple of 3 bytes, so that base64 padding appears only at the end.
+    const int chunkSize = 3 * 4096;
+    QXmlStreamWriter & writer = prepareForAppending();
+    writer.writeStartElement(tagName);
+    QString text;
+    for (int offset = 0; offset < data.size(); offset += chunkSize) {
+        const int size = std::min(chunkSize, data.size() - offset);
+        text.resize(encodedLength(size, encoding));
+        encodeBinary(data.constData() + offset, size, encoding, text.data());
+        writer.writeCharacters(text);
+    }
+    writer.writeEndElement();
+}
+
+void StreamElement::appendChildStringList(
+    const QString & listTagName, const QString & stringTagName,
+    const QStringList & list)
+{
+    QXmlStreamWriter & writer = prepareForAppending();
+    writer.writeStartElement(listTagName);
+    for (const QString & str : list)
+        writer.writeTextElement(stringTagName, str);
+    writer.writeEndElement();
+}
+
+void StreamElement::close()
+{
+    if (document_ == nullptr)
+        return;
+    std::vector<unsigned> & openElements = document_->openElements_;
+    if (depth_ < openElements.size() && openElements[depth_] == id_) {
+        while (openElements.size() > depth_) {
+            document_->writer_.writeEndElement();
+            openElements.pop_back();
+        }
+    }
+}
+
+StreamElement::StreamElement(StreamDocument & document)
+    : document_(& document), id_(++document.lastId_),
+      depth_(document.openElements_.size())
+{
+    document.openElements_.push_back(id_);
+}
+
+QXmlStreamWriter & StreamElement::prepareForAppending()
+{
+    if (document_ != nullptr) {
+        std::vector<unsigned> & openElements = document_->openElements_;
+        if (depth_ < openElements.size() && openElements[depth_] == id_) {
+            while (openElements.size() > depth_ + 1) {
+                document_->writer_.writeEndElement();
+                openElements.pop_back();
+            }
+            return document_->writer_;
+        }
+    }
+    throw WriteError(
+        QObject::tr("could not append to an XML element that is closed."));
+}
+
+void StreamElement::appendChildWithAttributeText(
+    const QString & tagName, const QString & text,
+    const QString & attributeName, const QString & attributeText)
+{
+    QXmlStreamWriter & writer = prepareForAppending();
+    writer.writeStartElement(tagName);
+    writer.writeAttribute(attributeName, attributeText);
+    writer.writeCharacters(text);
+    writer.writeEndElement();
+}
+
+
+StreamDocument::StreamDocument(QIODevice & device, const QString & rootTagName,
+                               const int indent)
+    : lastId_(0), finished_(false)
+{
+    initialize(device, rootTagName, indent);
+}
+
+StreamDocument::StreamDocument(const QString & filename,
+                               const QString & rootTagName, const int indent)
+    : filename_(filename), lastId_(0), finished_(false)
+{
+    makePathTo(filename);
+    file_.reset(new File(filename));
+    if (! file_->open(QIODevice::WriteOnly)) {
+        throw WriteError(
+            QObject::tr("could not open file %1 for writing.").arg(filename));
+    }
+    initialize(*file_, rootTagName, indent);
+}
+
+StreamDocument::~StreamDocument()
+{
+    if (finished_)
+        return;
+    // Prevents root_ and other elements from writing their end tags, so
+    // that the incomplete output can not be mistaken for a whole document.
+    openElements_.clear();
+    if (file_ != nullptr)
+        closeFile(true);
+}
+
+void StreamDocument::finish()
+{
+    if (finished_)
+        return;
+    finished_ = true;
+    root_->close();
+    writer_.writeEndDocument();
+    bool failed = writer_.hasError();
+    if (file_ != nullptr && ! closeFile(failed))
+        failed = true;
+    if (failed) {
+        throw WriteError(
+            filename_.isEmpty() ?
+            QObject::tr("error occurred while writing XML document.") :
+            QObject::tr(
+                "error occurred while writing to file %1.").arg(filename_));
+    }
+}
+
+void StreamDocument::initialize(QIODevice & device, const QString & rootTagName,
+                                const int indent)
+{
+    writer_.setDevice(& device);
+    if (indent >= 0) {
+        writer_.setAutoFormatting(true);
+        writer_.setAutoFormattingIndent(indent);
+    }
+    writer_.writeStartDocument();
+    writer_.writeStartElement(rootTagName);
+    root_.reset(new StreamElement(*this));
+}
+
+bool StreamDocument::closeFile(const bool discard)
+{
+# if QT_VERSION >= QT_VERSION_CHECK(5, 1, 0)
+    // Uncommitted output is discarded by QSaveFile's destructor.
+    if (discard)
+        return false;
+    return file_->commit();
+# else
+    const bool flushed = ! discard && file_->flush();
+    file_->close();
+    if (discard) {
+        // The original content is lost already; an incomplete document is
+        // worse than none.
+        QFile::remove(filename_);
+        return false;
+    }
+    return flushed && file_->error() == QFile::NoError;
+# endif
+}
+
+} // END namespace XmlWriting
+} // END namespace QtUtilities
@@ -0,0 +1,325 @@
+/*
+ This file is part of vedgTools/QtXmlUtilities.
+ Copyright (C) 2014, 2015 Igor Kushnir <igorkuo AT Google mail>
+
+ vedgTools/QtXmlUtilities is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ vedgTools/QtXmlUtilities is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ vedgTools/QtXmlUtilities.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# ifndef QT_XML_UTILITIES_STRUCT_BINDING_INL_HPP
+# define QT_XML_UTILITIES_STRUCT_BINDING_INL_HPP
+
+# include <QtXmlUtilities/StructBinding.hpp>
+
+# include <QtXmlUtilities/ReadingShortcuts.hpp>
+# include <QtXmlUtilities/StreamReading.hpp>
+# include <QtXmlUtilities/WritingShortcuts.hpp>
+# include <QtXmlUtilities/StreamWriting.hpp>
+
+# include <QtCoreUtilities/Error.hpp>
+# include <QtCoreUtilities/String.hpp>
+# include <QtCoreUtilities/Validation.hpp>
+
+# include <QString>
+# include <QObject>
+# include <QDomElement>
+
+# include <cstddef>
+# include <utility>
+# include <tuple>
+# include <array>
+# include <type_traits>
+
+
+namespace QtUtilities
+{
+namespace XmlBinding
+{
+namespace detail
+{
+template <typename T>
+void MinValidator<T>::operator()(const T & value) const
+{
+    checkMinValue(value, minValue);
+}
+
+template <typename T>
+void MaxValidator<T>::operator()(const T & value) const
+{
+    checkMaxValue(value, maxValue);
+}
+
+template <typename T>
+void RangeValidator<T>::operator()(const T & value) const
+{
+    checkRange(value, minValue, maxValue);
+}
+
+template <typename T>
+void Range0AllowedValidator<T>::operator()(const T & value) const
+{
+    checkRange0Allowed(value, minValue, maxValue);
+}
+
+
+template <typename T>
+struct TextConverter {
+    static T fromText(const QString & text, const QString & tagName) {
+        return XmlReading::detail::convertText<T>(text, tagName);
+    }
+    static QString toText(const T & value) { return toQString(value); }
+};
+
+template <>
+struct TextConverter<QString> {
+    static QString fromText(const QString & text, const QString &) {
+        return text;
+    }
+    static QString toText(const QString & value) { return value; }
+};
+
+/// @brief Converts text to the type of the member and validates it.
+template <class Struct, typename T, typename Validator>
+T convertField(const Field<Struct, T, Validator> & f, const QString & text)
+{
+    T value = TextConverter<T>::fromText(text, f.tagName);
+    Validator validator = f.validator;
+    XmlReading::detail::validate(value, f.tagName, validator);
+    return value;
+}
+
+template <class Struct, typename T, typename Validator>
+QString fieldText(const Field<Struct, T, Validator> & f, const Struct & source)
+{
+    return TextConverter<T>::toText(source.*f.member);
+}
+
+/// @brief Calls function(index, field) for each field in fields at compile
+/// time. index is std::integral_constant<std::size_t, I>, so it can be used
+/// both as a run-time index and as a template argument.
+template <std::size_t I = 0, class Tuple, typename Function>
+typename std::enable_if<I == std::tuple_size<Tuple>::value>::type
+forEachField(const Tuple &, Function &)
+{
+}
+
+template <std::size_t I = 0, class Tuple, typename Function>
+typename std::enable_if<I < std::tuple_size<Tuple>::value>::type
+forEachField(const Tuple & fields, Function & function)
+{
+    function(std::integral_constant<std::size_t, I>(), std::get<I>(fields));
+    forEachField<I + 1>(fields, function);
+}
+
+struct IndexInserter {
+    template <class F>
+    void operator()(const std::size_t index, const F & f) {
+        if (indices.contains(f.tagName)) {
+            throw Error(QObject::tr("tag name %1 is bound to more than one "
+                                    "field.").arg(f.tagName));
+        }
+        indices.insert(f.tagName, int(index));
+    }
+
+    QHash<QString, int> & indices;
+};
+
+/// @brief Converts found texts into values, which are stored in a tuple.
+template <class Values, std::size_t N>
+struct FieldConverter {
+    template <class Index, class F>
+    void operator()(const Index index, const F & f) {
+        if (found[index])
+            std::get<Index::value>(values) = convertField(f, texts[index]);
+    }
+
+    const std::array<QString, N> & texts;
+    const std::array<bool, N> & found;
+    Values & values;
+};
+
+/// @brief Moves converted values into the members of destination.
+template <class Struct, class Values, std::size_t N>
+struct ValueAssigner {
+    template <class Index, class F>
+    void operator()(const Index index, const F & f) {
+        if (found[index])
+            destination.*f.member = std::move(std::get<Index::value>(values));
+    }
+
+    Values & values;
+    const std::array<bool, N> & found;
+    Struct & destination;
+};
+
+template <class Struct, class TElement>
+struct FieldWriter {
+    template <class F>
+    void operator()(std::size_t, const F & f) {
+        e.appendChild(f.tagName, fieldText(f, source));
+    }
+
+    TElement & e;
+    const Struct & source;
+};
+
+} // END namespace detail
+
+
+template <class Struct, typename T>
+Field<Struct, T, detail::NoValidation> field(const QString & tagName,
+                                              T Struct::* const member)
+{
+    return { tagName, member, detail::NoValidation() };
+}
+
+template <class Struct, typename T, typename Validator>
+Field<Struct, T, Validator> field(const QString & tagName,
+                                  T Struct::* const member,
+                                  Validator validator)
+{
+    return { tagName, member, std::move(validator) };
+}
+
+template <class Struct, typename T>
+Field<Struct, T, detail::MinValidator<T>> fieldMin(
+    const QString & tagName, T Struct::* const member, T minValue)
+{
+    return { tagName, member, { std::move(minValue) } };
+}
+
+template <class Struct, typename T>
+Field<Struct, T, detail::MaxValidator<T>> fieldMax(
+    const QString & tagName, T Struct::* const member, T maxValue)
+{
+    return { tagName, member, { std::move(maxValue) } };
+}
+
+template <class Struct, typename T>
+Field<Struct, T, detail::RangeValidator<T>> fieldRange(
+    const QString & tagName, T Struct::* const member,
+    T minValue, T maxValue)
+{
+    return { tagName, member, { std::move(minValue), std::move(maxValue) } };
+}
+
+template <class Struct, typename T>
+Field<Struct, T, detail::Range0AllowedValidator<T>> fieldRange0Allowed(
+    const QString & tagName, T Struct::* const member,
+    T minValue, T maxValue)
+{
+    return { tagName, member, { std::move(minValue), std::move(maxValue) } };
+}
+
+
+template <class Struct, class... Fields>
+StructBinding<Struct, Fields...>::StructBinding(Fields... fields)
+    : fields_(std::move(fields)...)
+{
+    static_assert(sizeof...(Fields) != 0, "StructBinding without fields.");
+    detail::IndexInserter inserter { indices_ };
+    detail::forEachField(fields_, inserter);
+}
+
+template <class Struct, class... Fields>
+void StructBinding<Struct, Fields...>::read(const QDomElement & e,
+                                            Struct & destination) const
+{
+    std::array<QDomElement, sizeof...(Fields)> children;
+    for (QDomElement child = e.firstChildElement(); ! child.isNull();
+            child = child.nextSiblingElement()) {
+        const int index = indexOf(child.tagName());
+        if (index == -1)
+            continue;
+        QDomElement & fieldChild = children[std::size_t(index)];
+        if (! fieldChild.isNull())
+            XmlReading::detail::throwNotUniqueError(child.tagName());
+        fieldChild = child;
+    }
+
+    Texts texts;
+    Found found;
+    for (std::size_t i = 0; i < children.size(); ++i) {
+        found[i] = ! children[i].isNull();
+        if (found[i])
+            texts[i] = children[i].text();
+    }
+    assign(texts, found, destination);
+}
+
+template <class Struct, class... Fields>
+void StructBinding<Struct, Fields...>::read(
+    XmlReading::StreamReader & reader, Struct & destination) const
+{
+    Texts texts;
+    Found found;
+    found.fill(false);
+    reader.readChildren([&](XmlReading::StreamReader & child) {
+        const int index = indexOf(child.tagName());
+        if (index == -1)
+            return;
+        const std::size_t i = std::size_t(index);
+        if (found[i])
+            XmlReading::detail::throwNotUniqueError(child.tagName());
+        texts[i] = child.readText();
+        found[i] = true;
+    });
+    assign(texts, found, destination);
+}
+
+template <class Struct, class... Fields>
+void StructBinding<Struct, Fields...>::assign(const Texts & texts,
+                                              const Found & found,
+                                              Struct & destination) const
+{
+    typedef std::tuple<typename Fields::ValueType...> Values;
+    Values values;
+    detail::FieldConverter<Values, sizeof...(Fields)> converter {
+        texts, found, values };
+    detail::forEachField(fields_, converter);
+
+    detail::ValueAssigner<Struct, Values, sizeof...(Fields)> assigner {
+        values, found, destination };
+    detail::forEachField(fields_, assigner);
+}
+
+template <class Struct, class... Fields>
+void StructBinding<Struct, Fields...>::write(XmlWriting::Element & e,
+                                             const Struct & source) const
+{
+    detail::FieldWriter<Struct, XmlWriting::Element> writer { e, source };
+    detail::forEachField(fields_, writer);
+}
+
+template <class Struct, class... Fields>
+void StructBinding<Struct, Fields...>::write(XmlWriting::StreamElement & e,
+                                             const Struct & source) const
+{
+    detail::FieldWriter<Struct, XmlWriting::StreamElement> writer {
+        e, source };
+    detail::forEachField(fields_, writer);
+}
+
+
+template <class Field0, class... Fields>
+StructBinding<typename Field0::StructType, Field0, Fields...>
+makeStructBinding(Field0 field0, Fields... fields)
+{
+    return StructBinding<typename Field0::StructType, Field0, Fields...>(
+               std::move(field0), std::move(fields)...);
+}
+
+} // END namespace XmlBinding
+} // END namespace QtUtilities
+
+# endif // QT_XML_UTILITIES_STRUCT_BINDING_INL_HPP
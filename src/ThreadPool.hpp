@@ -0,0 +1,97 @@
+/*
+ This file is part of vedgTools/QtXmlUtilities.
+ Copyright (C) 2014, 2015 Igor Kushnir <igorkuo AT Google mail>
+
+ vedgTools/QtXmlUtilities is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ vedgTools/QtXmlUtilities is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ vedgTools/QtXmlUtilities.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# ifndef QT_XML_UTILITIES_THREAD_POOL_HPP
+# define QT_XML_UTILITIES_THREAD_POOL_HPP
+
+# include <QRunnable>
+# include <QThreadPool>
+# include <QSemaphore>
+
+# include <utility>
+# include <atomic>
+
+
+namespace QtUtilities
+{
+/// @brief Private helpers for running tasks in a QThreadPool.
+namespace Parallel
+{
+/// @brief QRunnable that calls a function object.
+template <typename Function>
+class FunctionRunnable : public QRunnable
+{
+public:
+    explicit FunctionRunnable(Function function)
+        : function_(std::move(function)) {}
+
+    void run() override { function_(); }
+
+private:
+    Function function_;
+};
+
+/// @brief Runs function in pool.
+template <typename Function>
+void start(QThreadPool & pool, Function function)
+{
+    pool.start(new FunctionRunnable<Function>(std::move(function)));
+}
+
+/// @brief Runs function in pool if the pool has an idle thread.
+/// @return true if function was started.
+template <typename Function>
+bool tryStart(QThreadPool & pool, Function function)
+{
+    auto * const runnable = new FunctionRunnable<Function>(std::move(function));
+    if (pool.tryStart(runnable))
+        return true;
+    delete runnable;
+    return false;
+}
+
+/// @brief Calls function(i) for each i in [0, count) on the calling thread
+/// and on idle threads of pool. Returns when all calls have finished.
+/// As the calling thread takes part in the work, this function never waits
+/// for busy threads of pool and can be called from a task running in pool.
+/// NOTE: function must not throw.
+template <typename Function>
+void forEachIndex(QThreadPool & pool, const int count, Function function)
+{
+    std::atomic<int> next(0);
+    const auto work = [&next, count, &function] {
+        for (int i = next++; i < count; i = next++)
+            function(i);
+    };
+    QSemaphore finished;
+    int helperCount = 0;
+    while (helperCount < count - 1 &&
+            tryStart(pool, [&work, &finished] {
+                work();
+                finished.release();
+            })) {
+        ++helperCount;
+    }
+    work();
+    finished.acquire(helperCount);
+}
+
+} // END namespace Parallel
+} // END namespace QtUtilities
+
+# endif // QT_XML_UTILITIES_THREAD_POOL_HPP
@@ -0,0 +1,151 @@
+/*
+ This file is part of vedgTools/QtXmlUtilities.
+ Copyright (C) 2014, 2015 Igor Kushnir <igorkuo AT Google mail>
+
+ vedgTools/QtXmlUtilities is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ vedgTools/QtXmlUtilities is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ vedgTools/QtXmlUtilities.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+# include "WatchedDocument.hpp"
+
+# include <QString>
+# include <QByteArray>
+# include <QObject>
+# include <QFile>
+# include <QFileInfo>
+# include <QDateTime>
+# include <QCryptographicHash>
+# include <QMutexLocker>
+# include <QFileSystemWatcher>
+# include <QTimer>
+# include <QDomElement>
+
+# include <utility>
+
+
+namespace QtUtilities
+{
+namespace XmlReading
+{
+WatchedDocument::WatchedDocument(const QString & filename,
+                                 const QString & rootTagName)
+    : filename_(filename), rootTagName_(rootTagName), generation_(0)
+{
+    load(stamp(filename));
+}
+
+WatchedDocument::~WatchedDocument() = default;
+
+QDomElement WatchedDocument::root() const
+{
+    QMutexLocker locker(& mutex_);
+    return root_;
+}
+
+bool WatchedDocument::reloadIfChanged()
+{
+    const FileStamp fileStamp = stamp(filename_);
+    if (fileStamp.size == stamp_.size && fileStamp.modified == stamp_.modified)
+        return false;
+    return load(fileStamp);
+}
+
+# if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
+void WatchedDocument::watch(const int debounceMs, ChangeHandler onChange,
+                            ErrorHandler onError)
+{
+    onChange_ = std::move(onChange);
+    onError_ = std::move(onError);
+    if (watcher_ == nullptr) {
+        watcher_.reset(new QFileSystemWatcher);
+        debounceTimer_.reset(new QTimer);
+        debounceTimer_->setSingleShot(true);
+        QObject::connect(watcher_.get(), & QFileSystemWatcher::fileChanged,
+        [this](const QString &) {
+            rewatch();
+            debounceTimer_->start();
+        });
+        QObject::connect(debounceTimer_.get(), & QTimer::timeout, [this] {
+            // The file may have been missing when the notification arrived.
+            rewatch();
+            reloadFromWatcher();
+        });
+        watcher_->addPath(filename_);
+    }
+    debounceTimer_->setInterval(debounceMs);
+}
+
+void WatchedDocument::stopWatching()
+{
+    debounceTimer_.reset();
+    watcher_.reset();
+}
+
+void WatchedDocument::rewatch()
+{
+    // Editors often replace the file, which removes it from the watcher.
+    if (! watcher_->files().contains(filename_) &&
+            QFileInfo(filename_).exists()) {
+        watcher_->addPath(filename_);
+    }
+}
+# endif
+
+WatchedDocument::FileStamp WatchedDocument::stamp(const QString & filename)
+{
+    const QFileInfo info(filename);
+    return FileStamp { info.size(),
+                       info.lastModified().toMSecsSinceEpoch() };
+}
+
+bool WatchedDocument::load(const FileStamp & fileStamp)
+{
+    QFile file(filename_);
+    if (! file.open(QIODevice::ReadOnly)) {
+        throw ReadError(
+            QObject::tr("could not open file %1 for reading.").arg(filename_));
+    }
+    const QByteArray data = file.readAll();
+    QByteArray hash = QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+    if (hash == hash_) {
+        stamp_ = fileStamp;
+        return false;
+    }
+
+    QDomElement newRoot = detail::loadFileRootFromData(data, filename_);
+    if (! rootTagName_.isEmpty() && ! newRoot.isNull())
+        assertTagName(newRoot, rootTagName_);
+    {
+        QMutexLocker locker(& mutex_);
+        root_ = std::move(newRoot);
+    }
+    stamp_ = fileStamp;
+    hash_ = std::move(hash);
+    ++generation_;
+    return true;
+}
+
+void WatchedDocument::reloadFromWatcher()
+{
+    try {
+        if (reloadIfChanged() && onChange_)
+            onChange_(root());
+    }
+    catch (const ReadError & error) {
+        if (onError_)
+            onError_(error);
+    }
+}
+
+} // END namespace XmlReading
+} // END namespace QtUtilities
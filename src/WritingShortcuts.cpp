@@ -18,15 +18,40 @@
 
 # include "WritingShortcuts.hpp"
 
+# include "GzipDevice.hpp"
+
+# include <QtXmlUtilities/Statistics.hpp>
+
 # include <QtCoreUtilities/Miscellaneous.hpp>
 
+# include <QtGlobal>
+# include <QByteArray>
 # include <QString>
 # include <QStringList>
 # include <QObject>
 # include <QFile>
+# include <QFileInfo>
+# include <QCryptographicHash>
+# include <QElapsedTimer>
+# include <QIODevice>
+# include <QTextStream>
 # include <QDomElement>
 # include <QDomDocument>
 
+# if QT_VERSION >= QT_VERSION_CHECK(5, 1, 0)
+# include <QSaveFile>
+# endif
+
+# if defined Q_OS_UNIX
+# include <unistd.h>
+# elif defined Q_OS_WIN
+# include <io.h>
+# endif
+
+# include <cstddef>
+# include <cstring>
+# include <algorithm>
+
 
 namespace QtUtilities
 {
@@ -75,20 +100,316 @@ QDomElement createStringListElement(
 }
 
 
-void save(const QDomDocument & doc, const QString & filename, const int indent)
+namespace
+{
+/// @brief Flushes file's data to disk.
+/// @return true on success.
+bool syncToDisk(QFile & file)
+{
+    if (! file.flush())
+        return false;
+# if defined Q_OS_UNIX
+    return ::fsync(file.handle()) == 0;
+# elif defined Q_OS_WIN
+    return ::_commit(file.handle()) == 0;
+# else
+    return true;
+# endif
+}
+
+QByteArray hash(const QByteArray & data)
+{
+    return QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+}
+
+/// @return true if the rest of device's content is equal to data.
+bool deviceContentEquals(QIODevice & device, const QByteArray & data)
+{
+    const qint64 chunkSize = 64 * 1024;
+    int offset = 0;
+    while (offset < data.size()) {
+        const QByteArray chunk = device.read(chunkSize);
+        if (chunk.isEmpty() || chunk.size() > data.size() - offset ||
+                std::memcmp(chunk.constData(), data.constData() + offset,
+                            static_cast<std::size_t>(chunk.size())) != 0) {
+            return false;
+        }
+        offset += chunk.size();
+    }
+    return device.read(1).isEmpty();
+}
+
+/// @return true if file specified by filename exists and its content is
+/// equal to data. Files with ".gz" suffix are decompressed while comparing.
+bool fileContentEquals(const QString & filename, const QByteArray & data)
+{
+    QFile file(filename);
+    if (GzipDevice::hasGzipSuffix(filename)) {
+        if (! file.open(QIODevice::ReadOnly))
+            return false;
+        GzipDevice gzip(file);
+        return gzip.open(QIODevice::ReadOnly) &&
+               deviceContentEquals(gzip, data);
+    }
+    if (! file.exists() || file.size() != data.size() ||
+            ! file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    return deviceContentEquals(file, data);
+}
+
+[[noreturn]] void throwOpenError(const QString & filename)
+{
+    throw WriteError(
+        QObject::tr("could not open file %1 for writing.").arg(filename));
+}
+
+[[noreturn]] void throwWriteError(const QString & filename)
+{
+    throw WriteError(
+        QObject::tr("error occurred while writing to file %1.").arg(filename));
+}
+
+/// @brief Write-only device, which collects data written to it into blocks
+/// of bufferSize bytes before passing them to the underlying device, and
+/// optionally hashes all written data.
+class BufferedWriter : public QIODevice
+{
+public:
+    BufferedWriter(QIODevice & device, const int bufferSize,
+                   QCryptographicHash * const hash)
+        : device_(device), bufferSize_(std::max(bufferSize, 1)), hash_(hash) {
+        buffer_.reserve(bufferSize_);
+        open(QIODevice::WriteOnly);
+    }
+
+    /// @brief Writes buffered data to the underlying device.
+    /// @return true on success.
+    bool flushBuffer() {
+        if (buffer_.isEmpty())
+            return true;
+        const bool written = device_.write(buffer_) == buffer_.size();
+        buffer_.clear();
+        return written;
+    }
+
+protected:
+    qint64 readData(char *, qint64) override { return -1; }
+
+    qint64 writeData(const char * const data, const qint64 size) override {
+        if (hash_ != nullptr)
+            hash_->addData(data, static_cast<int>(size));
+        if (buffer_.size() + size > bufferSize_) {
+            if (! flushBuffer())
+                return -1;
+            if (size >= bufferSize_)
+                return device_.write(data, size) == size ? size : -1;
+        }
+        buffer_.append(data, static_cast<int>(size));
+        return size;
+    }
+
+private:
+    QIODevice & device_;
+    const int bufferSize_;
+    QCryptographicHash * const hash_;
+    QByteArray buffer_;
+};
+
+/// @brief Serializes doc into device through a buffer of bufferSize bytes.
+/// @param hash If not nullptr, the serialized data is added to it.
+/// @return true on success.
+bool writeDocument(const QDomDocument & doc, QIODevice & device,
+                   const int indent, const int bufferSize,
+                   QCryptographicHash * const hash)
+{
+    BufferedWriter writer(device, bufferSize, hash);
+    {
+        QTextStream stream(& writer);
+# if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+        stream.setCodec("UTF-8");
+# endif
+        doc.save(stream, indent);
+        stream.flush();
+        if (stream.status() != QTextStream::Ok)
+            return false;
+    }
+    return writer.flushBuffer();
+}
+
+/// @brief Calls write(file) or, if filename has ".gz" suffix, passes data
+/// written by write() through a gzip compressor into file.
+/// @return true on success.
+template <typename Write>
+bool writeMaybeCompressed(QIODevice & file, const QString & filename,
+                          Write & write)
+{
+    if (! GzipDevice::hasGzipSuffix(filename))
+        return write(file);
+    GzipDevice gzip(file);
+    if (! gzip.open(QIODevice::WriteOnly)) {
+        throw WriteError(QObject::tr("could not compress file %1: %2").arg(
+                             filename, gzip.errorString()));
+    }
+    return write(gzip) && gzip.finish();
+}
+
+/// @brief Opens file specified by filename and calls write(file).
+/// If filename has ".gz" suffix, the written data is gzip-compressed.
+/// @tparam Write Must be a callable object that takes a single parameter of
+/// type (QIODevice &) and returns false in case of error.
+template <typename Write>
+void writeFileImpl(const QString & filename, const bool atomicReplace,
+                   const bool sync, Write & write)
 {
     makePathTo(filename);
+# if QT_VERSION >= QT_VERSION_CHECK(5, 1, 0)
+    if (atomicReplace) {
+        QSaveFile file(filename);
+        if (! file.open(QIODevice::WriteOnly))
+            throwOpenError(filename);
+        if (! writeMaybeCompressed(file, filename, write) || ! file.commit())
+            throwWriteError(filename);
+        return;
+    }
+# else
+    Q_UNUSED(atomicReplace)
+# endif
     QFile file(filename);
 
-    if (! file.open(QIODevice::WriteOnly)) {
-        throw WriteError(
-            QObject::tr("could not open file %1 for writing.").arg(filename));
+    if (! file.open(QIODevice::WriteOnly))
+        throwOpenError(filename);
+    if (! writeMaybeCompressed(file, filename, write) ||
+            (sync && ! syncToDisk(file))) {
+        throwWriteError(filename);
     }
-    if (file.write(doc.toByteArray(indent)) == -1) {
-        throw WriteError(
-            QObject::tr(
-                "error occurred while writing to file %1.").arg(filename));
+}
+
+/// @brief Calls writeFileImpl() and records statistics of the call if they
+/// are enabled.
+template <typename Write>
+void writeFile(const QString & filename, const bool atomicReplace,
+               const bool sync, Write write)
+{
+    if (! XmlStatistics::isEnabled())
+        return writeFileImpl(filename, atomicReplace, sync, write);
+    const QString source = QObject::tr("file %1").arg(filename);
+    QElapsedTimer timer;
+    timer.start();
+    try {
+        writeFileImpl(filename, atomicReplace, sync, write);
     }
+    catch (...) {
+        XmlStatistics::detail::recordSave(source, -1, false,
+                                          timer.nsecsElapsed());
+        throw;
+    }
+    const qint64 nanoseconds = timer.nsecsElapsed();
+    XmlStatistics::detail::recordSave(source, QFileInfo(filename).size(),
+                                      true, nanoseconds);
+}
+
+void writeData(const QByteArray & data, const QString & filename,
+               const bool atomicReplace, const bool sync)
+{
+    writeFile(filename, atomicReplace, sync, [&data](QIODevice & device) {
+        return device.write(data) != -1;
+    });
+}
+
+} // END unnamed namespace
+
+
+constexpr int SaveOptions::defaultBufferSize;
+
+void save(const QDomDocument & doc, const QString & filename, const int indent)
+{
+    writeFile(filename, false, false, [&](QIODevice & device) {
+        return writeDocument(doc, device, indent,
+                             SaveOptions::defaultBufferSize, nullptr);
+    });
+}
+
+void saveData(const QByteArray & data, const QString & filename)
+{
+    writeData(data, filename, false, false);
+}
+
+namespace
+{
+/// @param digest If not nullptr, it is used and updated as described in
+/// save(doc, filename, options, digest).
+bool saveDataImpl(const QByteArray & data, const QString & filename,
+                  const SaveOptions & options, QByteArray * const digest)
+{
+    QByteArray newDigest;
+    if (digest != nullptr)
+        newDigest = hash(data);
+    if (options.skipIfUnchanged) {
+        const bool unchanged =
+            digest == nullptr || digest->isEmpty() ?
+            fileContentEquals(filename, data) :
+            newDigest == *digest &&
+            (GzipDevice::hasGzipSuffix(filename) ?
+             QFileInfo(filename).exists() :
+             QFileInfo(filename).size() == data.size());
+        if (unchanged) {
+            if (digest != nullptr)
+                *digest = newDigest;
+            return false;
+        }
+    }
+    writeData(data, filename, options.atomicReplace, options.syncToDisk);
+    if (digest != nullptr)
+        *digest = newDigest;
+    return true;
+}
+
+bool saveImpl(const QDomDocument & doc, const QString & filename,
+              const SaveOptions & options, QByteArray * const digest)
+{
+    if (options.skipIfUnchanged) {
+        return saveDataImpl(doc.toByteArray(options.indent), filename,
+                            options, digest);
+    }
+    QCryptographicHash newDigest(QCryptographicHash::Sha1);
+    QCryptographicHash * const hash =
+        digest == nullptr ? nullptr : & newDigest;
+    writeFile(filename, options.atomicReplace, options.syncToDisk,
+    [&](QIODevice & device) {
+        return writeDocument(doc, device, options.indent, options.bufferSize,
+                             hash);
+    });
+    if (digest != nullptr)
+        *digest = newDigest.result();
+    return true;
+}
+
+} // END unnamed namespace
+
+
+bool save(const QDomDocument & doc, const QString & filename,
+          const SaveOptions & options)
+{
+    return saveImpl(doc, filename, options, nullptr);
+}
+
+bool save(const QDomDocument & doc, const QString & filename,
+          const SaveOptions & options, QByteArray & digest)
+{
+    return saveImpl(doc, filename, options, & digest);
+}
+
+bool saveData(const QByteArray & data, const QString & filename,
+              const SaveOptions & options)
+{
+    return saveDataImpl(data, filename, options, nullptr);
+}
+
+bool saveData(const QByteArray & data, const QString & filename,
+              const SaveOptions & options, QByteArray & digest)
+{
+    return saveDataImpl(data, filename, options, & digest);
 }
 
 } // END namespace XmlWriting
@@ -0,0 +1,156 @@
+/*
+ This file is part of vedgTools/QtXmlUtilities.
+ Copyright (C) 2014, 2015 Igor Kushnir <igorkuo AT Google mail>
+
+ vedgTools/QtXmlUtilities is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ vedgTools/QtXmlUtilities is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ vedgTools/QtXmlUtilities.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Reads one shared CompactDocument from several threads at once and checks
+// that every thread sees the same, correct values.
+// Exits with nonzero status on failure.
+
+# include <QtXmlUtilities/CompactDocument.hpp>
+# include <QtXmlUtilities/ReadingShortcuts.hpp>
+
+# include <QtCoreUtilities/Error.hpp>
+
+# include <QByteArray>
+# include <QString>
+# include <QLatin1String>
+# include <QThread>
+# include <QDomDocument>
+
+# include <atomic>
+# include <memory>
+# include <vector>
+# include <iostream>
+
+
+namespace
+{
+using namespace QtUtilities;
+using namespace QtUtilities::XmlReading;
+
+const int itemCount = 500;
+const int threadCount = 8;
+const int passCount = 50;
+
+QByteArray makeData()
+{
+    QByteArray data = "<root><title>Shared</title>";
+    for (int i = 0; i < itemCount; ++i) {
+        const QByteArray number = QByteArray::number(i);
+        data += "<item id=\"" + number + "\"><name>item " + number +
+                "</name><value>" + QByteArray::number(i * 3) +
+                "</value></item>";
+    }
+    data += "</root>";
+    return data;
+}
+
+/// @return Number of mismatches found in a single pass over document.
+int checkDocument(const CompactDocument & document)
+{
+    const QLatin1String itemTag("item");
+    int mismatches = 0;
+    const CompactElement root = document.root();
+    QString title;
+    if (! copyUniqueChildsTextTo(root, QLatin1String("title"), title) ||
+            title != QLatin1String("Shared")) {
+        ++mismatches;
+    }
+
+    int i = 0;
+    for (CompactElement item = root.firstChildElement(itemTag);
+            ! item.isNull(); item = item.nextSiblingElement(itemTag), ++i) {
+        int id = -1, value = -1;
+        if (! copyElementsAttributeTo(item, QLatin1String("id"), id) ||
+                id != i) {
+            ++mismatches;
+        }
+        if (! copyUniqueChildsTextTo(item, QLatin1String("value"), value) ||
+                value != i * 3) {
+            ++mismatches;
+        }
+        const QString name =
+            getUniqueChild(item, QLatin1String("name")).text();
+        if (name != QString(QLatin1String("item %1")).arg(i))
+            ++mismatches;
+    }
+    if (i != itemCount)
+        ++mismatches;
+    return mismatches;
+}
+
+class ReaderThread : public QThread
+{
+public:
+    ReaderThread(const CompactDocument & document,
+                 std::atomic<int> & mismatches, std::atomic<int> & errors)
+        : document_(document), mismatches_(mismatches), errors_(errors) {}
+
+protected:
+    void run() override {
+        try {
+            for (int pass = 0; pass < passCount; ++pass)
+                mismatches_ += checkDocument(document_);
+        }
+        catch (const Error &) {
+            ++errors_;
+        }
+    }
+
+private:
+    // Each thread reads the same shared data through a reference.
+    const CompactDocument & document_;
+    std::atomic<int> & mismatches_;
+    std::atomic<int> & errors_;
+};
+
+/// @return true if concurrent reads of document produced correct values.
+bool checkConcurrently(const CompactDocument & document, const char * name)
+{
+    std::atomic<int> mismatches(0), errors(0);
+    std::vector<std::unique_ptr<ReaderThread>> threads;
+    for (int i = 0; i < threadCount; ++i) {
+        threads.emplace_back(new ReaderThread(document, mismatches, errors));
+        threads.back()->start();
+    }
+    for (auto & thread : threads)
+        thread->wait();
+
+    if (mismatches != 0 || errors != 0) {
+        std::cerr << name << ": " << mismatches << " mismatches, " << errors
+                  << " errors." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // END unnamed namespace
+
+
+int main()
+{
+    const QByteArray data = makeData();
+    bool ok = checkConcurrently(loadCompactDocumentFromData(data), "loaded");
+
+    QDomDocument dom;
+    if (! dom.setContent(data)) {
+        std::cerr << "could not parse test data." << std::endl;
+        return 1;
+    }
+    ok = checkConcurrently(freeze(dom.documentElement()), "frozen") && ok;
+    return ok ? 0 : 1;
+}
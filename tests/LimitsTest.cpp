@@ -0,0 +1,97 @@
+/*
+ This file is part of vedgTools/QtXmlUtilities.
+ Copyright (C) 2014, 2015 Igor Kushnir <igorkuo AT Google mail>
+
+ vedgTools/QtXmlUtilities is free software: you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ vedgTools/QtXmlUtilities is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ vedgTools/QtXmlUtilities.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Checks that Limits are enforced by loadRootFromData(), including text
+// limits in elements with mixed content.
+// Exits with nonzero status on failure.
+
+# include <QtXmlUtilities/Limits.hpp>
+
+# include <QtCoreUtilities/Error.hpp>
+
+# include <QByteArray>
+# include <QDomElement>
+
+# include <iostream>
+
+
+namespace
+{
+using namespace QtUtilities;
+using namespace QtUtilities::XmlReading;
+
+/// @return true if loading data with limits throws LimitExceededError with
+/// limit=expected.
+bool exceeds(const QByteArray & data, const Limits & limits,
+             const LimitExceededError::Limit expected, const char * name)
+{
+    try {
+        loadRootFromData(data, limits);
+    }
+    catch (const LimitExceededError & error) {
+        if (error.limit() == expected)
+            return true;
+        std::cerr << name << ": unexpected limit exceeded: "
+                  << error.what() << std::endl;
+        return false;
+    }
+    catch (const Error & error) {
+        std::cerr << name << ": " << error.what() << std::endl;
+        return false;
+    }
+    std::cerr << name << ": no limit exceeded." << std::endl;
+    return false;
+}
+
+/// @return true if data is loaded with limits without errors.
+bool loads(const QByteArray & data, const Limits & limits, const char * name)
+{
+    try {
+        if (! loadRootFromData(data, limits).isNull())
+            return true;
+        std::cerr << name << ": null root." << std::endl;
+    }
+    catch (const Error & error) {
+        std::cerr << name << ": " << error.what() << std::endl;
+    }
+    return false;
+}
+
+} // END unnamed namespace
+
+
+int main()
+{
+    Limits limits;
+    limits.maxTextLength = 10;
+
+    bool ok = loads("<a>xxxx<b>yyyyyyyyyy</b>xxxx</a>", limits, "text");
+    // Each segment is within the limit, but their sum is not.
+    ok = exceeds("<a>xxxx<b/>xxxx<b/>xxxx</a>", limits,
+                 LimitExceededError::TextLength, "mixed content") && ok;
+    // Text of a child does not count toward its parent's text.
+    ok = exceeds("<a>xxxxxx<b>yyyyyyyyyy</b>xxxxx</a>", limits,
+                 LimitExceededError::TextLength, "parent after child") && ok;
+
+    limits = Limits();
+    limits.maxDepth = 2;
+    ok = loads("<a><b/><b/></a>", limits, "depth") && ok;
+    ok = exceeds("<a><b><c/></b></a>", limits, LimitExceededError::Depth,
+                 "depth exceeded") && ok;
+    return ok ? 0 : 1;
+}